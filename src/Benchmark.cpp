@@ -0,0 +1,283 @@
+#include "MyCollection.hpp"
+#include "PrettyPrinting.hpp"
+#include <iostream>
+#include <random>
+#include <string>
+#include <chrono>
+#include <algorithm>
+
+/**
+ * Contrairement à Test, chaque algorithme trie exactement la même collection (une copie de testCollection),
+ * ce qui permet de comparer les temps entre eux. Compilé en -O2 même si le reste du projet est en Debug.
+ * ./Benchmark 10000000
+ */
+
+using namespace mycollections;
+
+// un record de 32 octets: une clé et 24 octets de payload
+struct Record
+{
+    u32 key;
+    u32 row;
+    char payload[24];
+    bool operator<(Record const &other) const { return key < other.key; }
+    bool operator>(Record const &other) const { return key > other.key; }
+};
+
+// Sort: appelable avec un MyCollection<T> &
+template <typename T, typename Sort>
+void benchmark(const std::string &name, std::vector<T> &testCollection, Sort sort);
+template <typename Search>
+void lookupBenchmark(const std::string &name, std::vector<u32> const &probes, Search search);
+void selectionBenchmark(const std::string &name, std::vector<u32> &testCollection, std::vector<double> const &ps);
+void topKBenchmark(const std::string &name, std::vector<u32> const &stream, int k);
+void batchLookupBenchmark(const std::string &name, MyCollection<u32> const &collection, std::vector<u32> const &probes, bool sortKeys);
+
+int main(int argc, char *argv[])
+{
+    int size = argc > 1 ? std::stoi(argv[1]) : 1000000;
+
+    // même generation que dans Test.cpp
+    std::random_device os_seed;
+    const u32 seed = os_seed();
+    engine generator(seed);
+    std::uniform_int_distribution<u32> distribute(0, 1 << 16);
+
+    std::vector<u32> testCollection;
+    testCollection.reserve(size);
+    for (int i = 0; i < size; i++)
+        testCollection.emplace_back(distribute(generator));
+
+    sortConfig(); // la calibration de sort() (premier lancement seulement) ne doit pas compter dans les temps
+
+    myprint::boxedPrint("Benchmark on " + std::to_string(size) + " elements", 20, 1);
+
+    benchmark("mergeSortRecursive", testCollection, [](MyCollection<u32> &c)
+              { c.mergeSortRecursive(); });
+    benchmark("quickSort", testCollection, [](MyCollection<u32> &c)
+              { c.quickSort(); });
+    benchmark("introSort", testCollection, [](MyCollection<u32> &c)
+              { c.introSort(); });
+    benchmark("quickSort3Way", testCollection, [](MyCollection<u32> &c)
+              { c.quickSort3Way(); });
+    benchmark("blockQuickSort", testCollection, [](MyCollection<u32> &c)
+              { c.blockQuickSort(); });
+    benchmark("timSort", testCollection, [](MyCollection<u32> &c)
+              { c.timSort(); });
+    benchmark("mergeSortParallel", testCollection, [](MyCollection<u32> &c)
+              { c.mergeSortParallel(); });
+    benchmark("sampleSort", testCollection, [](MyCollection<u32> &c)
+              { c.sampleSort(); });
+    benchmark("radixSort", testCollection, [](MyCollection<u32> &c)
+              { c.radixSort(); });
+    benchmark("radixSortParallel", testCollection, [](MyCollection<u32> &c)
+              { c.radixSortParallel(); });
+    benchmark("countingSort", testCollection, [](MyCollection<u32> &c)
+              { c.countingSort(); });
+    benchmark("sort", testCollection, [](MyCollection<u32> &c)
+              { c.sort(); });
+
+    // selection: la médiane puis trois percentiles d'un coup, au lieu d'un tri complet
+    selectionBenchmark("percentile (p50)", testCollection, {50});
+    selectionBenchmark("percentiles (p50, p90, p99)", testCollection, {50, 90, 99});
+    benchmark("introSort (then read p50, p90, p99)", testCollection, [](MyCollection<u32> &c)
+              { c.introSort(); });
+    topKBenchmark("TopK (100 largest, streamed in chunks)", testCollection, 100);
+
+    // shards: la collection coupée en 16 collections triées, mergées au lieu d'être concaténées puis retriées
+    std::vector<MyCollection<u32>> shards;
+    for (int shard = 0; shard < 16; shard++)
+    {
+        std::vector<u32> part(testCollection.begin() + (long long)size * shard / 16, testCollection.begin() + (long long)size * (shard + 1) / 16);
+        shards.emplace_back(part);
+        shards.back().radixSort();
+    }
+    std::vector<u32> concatenated;
+    for (MyCollection<u32> const &shard : shards)
+    {
+        std::vector<u32> part = shard.getCollection();
+        concatenated.insert(concatenated.end(), part.begin(), part.end());
+    }
+
+    myprint::boxedPrint("Benchmark on " + std::to_string(size) + " elements in 16 sorted shards", 20, 1);
+
+    benchmark("timSort (concatenated)", concatenated, [](MyCollection<u32> &c)
+              { c.timSort(); });
+    benchmark("mergeFrom", concatenated, [&shards](MyCollection<u32> &c)
+              { c.mergeFrom(shards); });
+    benchmark("mergeFromParallel", concatenated, [&shards](MyCollection<u32> &c)
+              { c.mergeFromParallel(shards); });
+    std::vector<MyCollection<u32>> twoShards(shards.begin(), shards.begin() + 2);
+    benchmark("mergeFrom (2 shards)", concatenated, [&twoShards](MyCollection<u32> &c)
+              { c.mergeFrom(twoShards); });
+
+    // presque triée: la collection triée avec 1% de valeurs au hasard à la fin (des logs avec une fin dans le désordre)
+    std::vector<u32> nearlySorted(testCollection);
+    std::sort(nearlySorted.begin(), nearlySorted.end());
+    for (int i = size - size / 100; i < size; i++)
+        nearlySorted[i] = distribute(generator);
+
+    myprint::boxedPrint("Benchmark on " + std::to_string(size) + " nearly sorted elements", 20, 1);
+
+    benchmark("mergeSortRecursive", nearlySorted, [](MyCollection<u32> &c)
+              { c.mergeSortRecursive(); });
+    benchmark("introSort", nearlySorted, [](MyCollection<u32> &c)
+              { c.introSort(); });
+    benchmark("timSort", nearlySorted, [](MyCollection<u32> &c)
+              { c.timSort(); });
+    benchmark("sort", nearlySorted, [](MyCollection<u32> &c)
+              { c.sort(); });
+
+    // les mêmes clés avec un payload: records entiers (AoS) contre clés + payloads à part (SoA)
+    std::vector<Record> records(size);
+    for (int i = 0; i < size; i++)
+    {
+        records[i].key = testCollection[i];
+        records[i].row = i;
+    }
+    std::vector<Record> payloads(records);
+
+    myprint::boxedPrint("Benchmark on " + std::to_string(size) + " key/payload records", 20, 1);
+
+    benchmark("mergeSortRecursive (records)", records, [](MyCollection<Record> &c)
+              { c.mergeSortRecursive(); });
+    benchmark("sortWithPayload (keys + payloads)", testCollection, [&payloads](MyCollection<u32> &c)
+              { c.sortWithPayload(payloads); });
+
+    // les mêmes valeurs en chaînes avec un long préfixe commun, comme des URL
+    std::vector<std::string> urlCollection;
+    urlCollection.reserve(size);
+    for (int i = 0; i < size; i++)
+        urlCollection.emplace_back("https://www.example.com/items/" + std::to_string(testCollection[i]));
+
+    myprint::boxedPrint("Benchmark on " + std::to_string(size) + " URL strings", 20, 1);
+
+    benchmark("mergeSortRecursive", urlCollection, [](MyCollection<std::string> &c)
+              { c.mergeSortRecursive(); });
+    benchmark("blockQuickSort", urlCollection, [](MyCollection<std::string> &c)
+              { c.blockQuickSort(); });
+    benchmark("stringSort", urlCollection, [](MyCollection<std::string> &c)
+              { c.stringSort(); });
+
+    // recherches: une collection triée, puis autant de recherches que d'elements
+    myprint::boxedPrint("Benchmark on " + std::to_string(size) + " lookups", 20, 1);
+
+    MyCollection<u32> sortedCollection(testCollection);
+    sortedCollection.radixSort();
+    std::vector<u32> probes(size);
+    for (int i = 0; i < size; i++)
+        probes[i] = distribute(generator);
+
+    lookupBenchmark("binarySearch", probes, [&sortedCollection](u32 value)
+                    { return sortedCollection.lowerBound(value); });
+    lookupBenchmark("binarySearch (found)", probes, [&sortedCollection](u32 value)
+                    { return sortedCollection.binarySearch(value); });
+    batchLookupBenchmark("searchBatch", sortedCollection, probes, false);
+    batchLookupBenchmark("searchBatch (sortKeys)", sortedCollection, probes, true);
+    EytzingerIndex<u32> index = sortedCollection.buildIndex();
+    lookupBenchmark("EytzingerIndex", probes, [&index](u32 value)
+                    { return index.lowerBound(value); });
+    LearnedIndex<u32> learnedIndex = sortedCollection.buildLearnedIndex();
+    lookupBenchmark("LearnedIndex (max error " + std::to_string(learnedIndex.maxError()) + ", " + std::to_string(learnedIndex.modelSize()) + " bytes)", probes,
+                    [&learnedIndex](u32 value)
+                    { return learnedIndex.lowerBound(value); });
+
+    return 0;
+}
+
+template <typename T, typename Sort>
+void benchmark(const std::string &name, std::vector<T> &testCollection, Sort sort)
+{
+    MyCollection<T> collection(testCollection);
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    sort(collection);
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+    std::vector<T> result = collection.getCollection();
+    bool orderCheck = std::is_sorted(result.begin(), result.end());
+
+    std::chrono::duration<double> elapsed_seconds = end - start;
+    myprint::logger result_print;
+    result_print.str(" ");
+    result_print << name << " (" << orderCheck << ") Time Taken: " << elapsed_seconds.count() << "s";
+    myprint::boxedPrint(result_print.str());
+}
+
+template <typename Search>
+void lookupBenchmark(const std::string &name, std::vector<u32> const &probes, Search search)
+{
+    long long checksum = 0; // utilisé pour que les recherches ne soient pas supprimées par le compilateur
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < probes.size(); i++)
+        checksum += search(probes[i]);
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+    std::chrono::duration<double> elapsed_seconds = end - start;
+    myprint::logger result_print;
+    result_print.str(" ");
+    result_print << name << " (" << checksum << ") Time Taken: " << elapsed_seconds.count() << "s";
+    myprint::boxedPrint(result_print.str());
+}
+
+// binarySearch de toutes les sondes en un appel, le checksum est comparable à celui d'une boucle sur binarySearch (-1 pour les absentes)
+void batchLookupBenchmark(const std::string &name, MyCollection<u32> const &collection, std::vector<u32> const &probes, bool sortKeys)
+{
+    std::vector<int64_t> positions(probes.size());
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    collection.searchBatch(probes.data(), probes.size(), positions.data(), sortKeys);
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+    long long checksum = 0;
+    for (std::size_t i = 0; i < positions.size(); i++)
+        checksum += positions[i];
+
+    std::chrono::duration<double> elapsed_seconds = end - start;
+    myprint::logger result_print;
+    result_print.str(" ");
+    result_print << name << " (" << checksum << ") Time Taken: " << elapsed_seconds.count() << "s";
+    myprint::boxedPrint(result_print.str());
+}
+
+// les percentiles sont affichés à la place de l'ordre: la collection n'est que partitionnée
+void selectionBenchmark(const std::string &name, std::vector<u32> &testCollection, std::vector<double> const &ps)
+{
+    MyCollection<u32> collection(testCollection);
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::vector<u32> values = collection.percentiles(ps);
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+    std::chrono::duration<double> elapsed_seconds = end - start;
+    myprint::logger result_print;
+    result_print.str(" ");
+    result_print << name << " (";
+    for (std::size_t i = 0; i < values.size(); i++)
+        result_print << (i == 0 ? "" : ", ") << values[i];
+    result_print << ") Time Taken: " << elapsed_seconds.count() << "s";
+    myprint::boxedPrint(result_print.str());
+}
+
+// le plus petit des k gardés est affiché: le k-ième plus grand de la collection
+void topKBenchmark(const std::string &name, std::vector<u32> const &stream, int k)
+{
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    TopK<u32> top(k);
+    std::size_t position = 0;
+    top.pull([&stream, &position](u32 *buffer, int capacity)
+             {
+                 int count = std::min<std::size_t>(capacity, stream.size() - position);
+                 std::copy(stream.begin() + position, stream.begin() + position + count, buffer);
+                 position += count;
+                 return count; });
+    std::vector<u32> largest = top.result();
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+    std::chrono::duration<double> elapsed_seconds = end - start;
+    myprint::logger result_print;
+    result_print.str(" ");
+    result_print << name << " (" << (largest.empty() ? 0 : largest.back()) << ") Time Taken: " << elapsed_seconds.count() << "s";
+    myprint::boxedPrint(result_print.str());
+}
@@ -6,6 +6,8 @@
 #include <string>
 #include <chrono>
 #include <sstream>
+#include <cmath>
+#include <utility>
 
 #define NEW_COLLECTION                                      \
     testCollection.clear();                                 \
@@ -22,6 +24,15 @@ using namespace mycollections;
 using u32 = uint_least32_t; // u32 is the smallest datatype supported by the system that can hold at least 32 bits
 using engine = std::mt19937;
 
+// pour sortBy: pas d'opérateurs < et >, la collection n'est triable que sur une clé
+struct Person
+{
+    std::string name;
+    u32 age;
+    int id;
+    int getId() const { return id; }
+};
+
 template <typename T>
 bool checkingOrder(std::vector<T> const &a, int size, bool ascending);
 
@@ -147,6 +158,127 @@ int main(int argc, char *argv[])
     result_print << "(" << orderCheck << ") Time Taken: " << elapsed_seconds.count() << "s";
     myprint::boxedPrint(result_print.str());
 
+    // MergeSort BottomUp
+    myprint::boxedPrint("MergeSortBottomUp", 20, 1);
+
+    mytestCollection.shamble();
+
+    start = std::chrono::system_clock::now();
+
+    mytestCollection.mergeSortBottomUp();
+    mytestCollection.shamble();
+    mytestCollection.mergeSortBottomUp(false);
+
+    end = std::chrono::system_clock::now();
+
+    orderCheck = checkingOrder(mytestCollection.getCollection(), initial_size, false);
+
+    result_print.str(" "); // to clear the stream we need to replace the underlying string
+    elapsed_seconds = end - start;
+    result_print << "(" << orderCheck << ") Time Taken: " << elapsed_seconds.count() << "s";
+    myprint::boxedPrint(result_print.str());
+
+    // MergeSort avec un buffer fourni: trop petit au départ (redimensionné), puis réutilisé sans nouvelle allocation
+    myprint::boxedPrint("MergeSortBuffer", 20, 1);
+
+    std::vector<u32> sortedValues(testCollection);
+    std::sort(sortedValues.begin(), sortedValues.end());
+    std::vector<u32> mergeBuffer(initial_size / 2);
+    mytestCollection.shamble();
+
+    start = std::chrono::system_clock::now();
+
+    mytestCollection.mergeSortRecursive(true, mergeBuffer);
+    orderCheck = mytestCollection.getCollection() == sortedValues && (initial_size < 2 || (int)mergeBuffer.size() >= initial_size); // pas de tri en dessous de 2 elements
+    u32 const *reusedBuffer = mergeBuffer.data();
+    mytestCollection.shamble();
+    mytestCollection.mergeSortRecursive(false, mergeBuffer);
+    orderCheck = orderCheck && mytestCollection.getCollection() == std::vector<u32>(sortedValues.rbegin(), sortedValues.rend()) && mergeBuffer.data() == reusedBuffer;
+    mytestCollection.shamble();
+    mytestCollection.mergeSortBottomUp(true, mergeBuffer);
+    orderCheck = orderCheck && mytestCollection.getCollection() == sortedValues && mergeBuffer.data() == reusedBuffer;
+    mergeBuffer.assign(initial_size / 2, 0);
+    mytestCollection.shamble();
+    mytestCollection.mergeSortBottomUp(false, mergeBuffer);
+    orderCheck = orderCheck && mytestCollection.getCollection() == std::vector<u32>(sortedValues.rbegin(), sortedValues.rend());
+
+    end = std::chrono::system_clock::now();
+
+    result_print.str(" "); // to clear the stream we need to replace the underlying string
+    elapsed_seconds = end - start;
+    result_print << "(" << orderCheck << ") Time Taken: " << elapsed_seconds.count() << "s";
+    myprint::boxedPrint(result_print.str());
+
+    // MergeSort Parallel
+    myprint::boxedPrint("MergeSortParallel", 20, 1);
+
+    mytestCollection.shamble();
+
+    start = std::chrono::system_clock::now();
+
+    mytestCollection.mergeSortParallel();
+    mytestCollection.shamble();
+    mytestCollection.mergeSortParallel(false);
+
+    end = std::chrono::system_clock::now();
+
+    orderCheck = checkingOrder(mytestCollection.getCollection(), initial_size, false);
+
+    result_print.str(" "); // to clear the stream we need to replace the underlying string
+    elapsed_seconds = end - start;
+    result_print << "(" << orderCheck << ") Time Taken: " << elapsed_seconds.count() << "s";
+    myprint::boxedPrint(result_print.str());
+
+    // MergeSortParallel sur des std::string, assez pour 4 threads quelle que soit la taille demandée:
+    // un move vide la chaîne source, un thread qui la lirait encore donnerait des chaînes vides dans le resultat
+    myprint::boxedPrint("MergeSortParallel<string>", 20, 1);
+
+    std::vector<std::string> stringCollection;
+    for (int i = 0; i < 4 * PARALLEL_MIN_CHUNK; i++)
+        stringCollection.emplace_back("item-" + std::to_string(distribute(generator)));
+    std::vector<std::string> sortedStrings(stringCollection);
+    std::sort(sortedStrings.begin(), sortedStrings.end());
+    MyCollection<std::string> myStringCollection(stringCollection);
+
+    start = std::chrono::system_clock::now();
+
+    myStringCollection.mergeSortParallel(true, 4);
+    orderCheck = myStringCollection.getCollection() == sortedStrings;
+    myStringCollection.shamble();
+    myStringCollection.mergeSortParallel(false, 4);
+    orderCheck = orderCheck && myStringCollection.getCollection() == std::vector<std::string>(sortedStrings.rbegin(), sortedStrings.rend());
+    myStringCollection.shamble();
+    myStringCollection.radixSortParallel(true, 4); // pas de clé radix: mergeSortParallel
+    orderCheck = orderCheck && myStringCollection.getCollection() == sortedStrings;
+
+    end = std::chrono::system_clock::now();
+
+    result_print.str(" "); // to clear the stream we need to replace the underlying string
+    elapsed_seconds = end - start;
+    result_print << "(" << orderCheck << ") Time Taken: " << elapsed_seconds.count() << "s";
+    myprint::boxedPrint(result_print.str());
+
+    // TimSort
+    myprint::boxedPrint("TimSort", 20, 1);
+
+    mytestCollection.shamble();
+
+    start = std::chrono::system_clock::now();
+
+    mytestCollection.timSort();
+    mytestCollection.shamble();
+    mytestCollection.timSort(false);
+
+    end = std::chrono::system_clock::now();
+
+    orderCheck = checkingOrder(mytestCollection.getCollection(), initial_size, false);
+
+    result_print.str(" "); // to clear the stream we need to replace the underlying string
+    elapsed_seconds = end - start;
+    result_print << "(" << orderCheck << ") Time Taken: " << elapsed_seconds.count() << "s";
+
+    myprint::boxedPrint(result_print.str());
+
     // Quicksort
     myprint::boxedPrint("QuickSort", 20, 1);
 
@@ -172,6 +304,482 @@ int main(int argc, char *argv[])
 
     myprint::boxedPrint(result_print.str());
 
+    // IntroSort
+    myprint::boxedPrint("IntroSort", 20, 1);
+
+    mytestCollection.shamble();
+
+    start = std::chrono::system_clock::now();
+
+    mytestCollection.introSort();
+    mytestCollection.shamble();
+    mytestCollection.introSort(false);
+
+    end = std::chrono::system_clock::now();
+
+    orderCheck = checkingOrder(mytestCollection.getCollection(), initial_size, false);
+
+    result_print.str(" "); // to clear the stream we need to replace the underlying string
+    elapsed_seconds = end - start;
+    result_print << "(" << orderCheck << ") Time Taken: " << elapsed_seconds.count() << "s";
+
+    myprint::boxedPrint(result_print.str());
+
+    // QuickSort 3 Way
+    myprint::boxedPrint("QuickSort3Way", 20, 1);
+
+    mytestCollection.shamble();
+
+    start = std::chrono::system_clock::now();
+
+    mytestCollection.quickSort3Way();
+    mytestCollection.shamble();
+    mytestCollection.quickSort3Way(false);
+
+    end = std::chrono::system_clock::now();
+
+    orderCheck = checkingOrder(mytestCollection.getCollection(), initial_size, false);
+
+    result_print.str(" "); // to clear the stream we need to replace the underlying string
+    elapsed_seconds = end - start;
+    result_print << "(" << orderCheck << ") Time Taken: " << elapsed_seconds.count() << "s";
+
+    myprint::boxedPrint(result_print.str());
+
+    // BlockQuickSort
+    myprint::boxedPrint("BlockQuickSort", 20, 1);
+
+    mytestCollection.shamble();
+
+    start = std::chrono::system_clock::now();
+
+    mytestCollection.blockQuickSort();
+    mytestCollection.shamble();
+    mytestCollection.blockQuickSort(false);
+
+    end = std::chrono::system_clock::now();
+
+    orderCheck = checkingOrder(mytestCollection.getCollection(), initial_size, false);
+
+    result_print.str(" "); // to clear the stream we need to replace the underlying string
+    elapsed_seconds = end - start;
+    result_print << "(" << orderCheck << ") Time Taken: " << elapsed_seconds.count() << "s";
+
+    myprint::boxedPrint(result_print.str());
+
+    // SampleSort
+    myprint::boxedPrint("SampleSort", 20, 1);
+
+    // en plus de la collection de test, 2¹⁷ elements sur 4 threads quelle que soit la taille demandée: en dessous de SAMPLESORT_MIN_SIZE
+    // ou avec un seul thread sampleSort n'est que blockQuickSort. Une fois au hasard, une fois avec beaucoup de doublons (buckets d'égalité)
+    std::vector<u32> largeValues, fewDistinctValues;
+    for (int i = 0; i < 1 << 17; i++)
+    {
+        largeValues.push_back(distribute(generator));
+        fewDistinctValues.push_back(largeValues.back() % 16);
+    }
+    std::vector<u32> sortedLarge(largeValues), sortedFewDistinct(fewDistinctValues);
+    std::sort(sortedLarge.begin(), sortedLarge.end());
+    std::sort(sortedFewDistinct.begin(), sortedFewDistinct.end());
+    MyCollection<u32> myLarge(largeValues), myFewDistinct(fewDistinctValues);
+
+    mytestCollection.shamble();
+
+    start = std::chrono::system_clock::now();
+
+    mytestCollection.sampleSort();
+    mytestCollection.shamble();
+    mytestCollection.sampleSort(false);
+    myLarge.sampleSort(true, 4);
+    myFewDistinct.sampleSort(false, 4);
+
+    end = std::chrono::system_clock::now();
+
+    orderCheck = checkingOrder(mytestCollection.getCollection(), initial_size, false) && myLarge.getCollection() == sortedLarge &&
+                 myFewDistinct.getCollection() == std::vector<u32>(sortedFewDistinct.rbegin(), sortedFewDistinct.rend());
+
+    result_print.str(" "); // to clear the stream we need to replace the underlying string
+    elapsed_seconds = end - start;
+    result_print << "(" << orderCheck << ") Time Taken: " << elapsed_seconds.count() << "s";
+
+    myprint::boxedPrint(result_print.str());
+
+    // RadixSort
+    myprint::boxedPrint("RadixSort", 20, 1);
+
+    mytestCollection.shamble();
+
+    start = std::chrono::system_clock::now();
+
+    mytestCollection.radixSort();
+    mytestCollection.shamble();
+    mytestCollection.radixSort(false);
+
+    end = std::chrono::system_clock::now();
+
+    orderCheck = checkingOrder(mytestCollection.getCollection(), initial_size, false);
+
+    result_print.str(" "); // to clear the stream we need to replace the underlying string
+    elapsed_seconds = end - start;
+    result_print << "(" << orderCheck << ") Time Taken: " << elapsed_seconds.count() << "s";
+
+    myprint::boxedPrint(result_print.str());
+
+    // RadixSort Parallel
+    myprint::boxedPrint("RadixSortParallel", 20, 1);
+
+    // comme pour SampleSort: les 2¹⁷ elements sur 4 threads passent par le scatter MSD avec un histogramme par thread
+    myLarge.setCollection(largeValues);
+    myFewDistinct.setCollection(fewDistinctValues);
+    mytestCollection.shamble();
+
+    start = std::chrono::system_clock::now();
+
+    mytestCollection.radixSortParallel();
+    mytestCollection.shamble();
+    mytestCollection.radixSortParallel(false);
+    myLarge.radixSortParallel(false, 4);
+    myFewDistinct.radixSortParallel(true, 4);
+
+    end = std::chrono::system_clock::now();
+
+    orderCheck = checkingOrder(mytestCollection.getCollection(), initial_size, false) && myLarge.getCollection() == std::vector<u32>(sortedLarge.rbegin(), sortedLarge.rend()) &&
+                 myFewDistinct.getCollection() == sortedFewDistinct;
+
+    result_print.str(" "); // to clear the stream we need to replace the underlying string
+    elapsed_seconds = end - start;
+    result_print << "(" << orderCheck << ") Time Taken: " << elapsed_seconds.count() << "s";
+
+    myprint::boxedPrint(result_print.str());
+
+    // CountingSort
+    myprint::boxedPrint("CountingSort", 20, 1);
+
+    mytestCollection.shamble();
+
+    start = std::chrono::system_clock::now();
+
+    mytestCollection.countingSort();
+    mytestCollection.shamble();
+    mytestCollection.countingSort(false);
+
+    end = std::chrono::system_clock::now();
+
+    orderCheck = checkingOrder(mytestCollection.getCollection(), initial_size, false);
+
+    result_print.str(" "); // to clear the stream we need to replace the underlying string
+    elapsed_seconds = end - start;
+    result_print << "(" << orderCheck << ") Time Taken: " << elapsed_seconds.count() << "s";
+
+    myprint::boxedPrint(result_print.str());
+
+    // RadixSort<int64_t>: négatifs et clés de plus de 32 bits
+    myprint::boxedPrint("RadixSort<int64_t>", 20, 1);
+
+    std::vector<int64_t> int64Collection;
+    for (int i = 0; i < initial_size; i++)
+        int64Collection.emplace_back(((int64_t)distribute(generator) << 32) - ((int64_t)distribute(generator) << 40) + distribute(generator));
+    std::vector<int64_t> sortedInt64(int64Collection);
+    std::sort(sortedInt64.begin(), sortedInt64.end());
+    MyCollection<int64_t> myInt64Collection(int64Collection);
+    myInt64Collection.shamble();
+
+    start = std::chrono::system_clock::now();
+
+    myInt64Collection.radixSort();
+    orderCheck = myInt64Collection.getCollection() == sortedInt64;
+    myInt64Collection.shamble();
+    myInt64Collection.radixSort(false);
+    orderCheck = orderCheck && myInt64Collection.getCollection() == std::vector<int64_t>(sortedInt64.rbegin(), sortedInt64.rend());
+
+    end = std::chrono::system_clock::now();
+
+    result_print.str(" "); // to clear the stream we need to replace the underlying string
+    elapsed_seconds = end - start;
+    result_print << "(" << orderCheck << ") Time Taken: " << elapsed_seconds.count() << "s";
+
+    myprint::boxedPrint(result_print.str());
+
+    // RadixSort<float>: négatifs, -0.0 et +0.0 (égaux), infinis et NaN (aprés +inf en ordre croissant, en premier en décroissant)
+    myprint::boxedPrint("RadixSort<float>", 20, 1);
+
+    std::vector<float> floatCollection;
+    for (int i = 0; i < initial_size; i++)
+        floatCollection.emplace_back(((float)distribute(generator) - (1 << 15)) / 8);
+    std::vector<float> specialFloats = {-0.0f, 0.0f, NAN, INFINITY, -INFINITY, NAN};
+    floatCollection.insert(floatCollection.end(), specialFloats.begin(), specialFloats.end());
+    std::vector<float> sortedFloats; // sans les NaN
+    for (float value : floatCollection)
+        if (!std::isnan(value))
+            sortedFloats.push_back(value);
+    std::sort(sortedFloats.begin(), sortedFloats.end());
+    int const nanCount = floatCollection.size() - sortedFloats.size();
+    MyCollection<float> myFloatCollection(floatCollection);
+
+    start = std::chrono::system_clock::now();
+
+    myFloatCollection.radixSort();
+    std::vector<float> floats = myFloatCollection.getCollection();
+    orderCheck = std::equal(sortedFloats.begin(), sortedFloats.end(), floats.begin()) &&
+                 std::all_of(floats.end() - nanCount, floats.end(), [](float value)
+                             { return std::isnan(value); });
+    myFloatCollection.shamble();
+    myFloatCollection.radixSort(false);
+    floats = myFloatCollection.getCollection();
+    orderCheck = orderCheck && std::equal(sortedFloats.rbegin(), sortedFloats.rend(), floats.begin() + nanCount) &&
+                 std::all_of(floats.begin(), floats.begin() + nanCount, [](float value)
+                             { return std::isnan(value); });
+
+    end = std::chrono::system_clock::now();
+
+    result_print.str(" "); // to clear the stream we need to replace the underlying string
+    elapsed_seconds = end - start;
+    result_print << "(" << orderCheck << ") Time Taken: " << elapsed_seconds.count() << "s";
+
+    myprint::boxedPrint(result_print.str());
+
+    // RadixSort<pair>: clé composée, la premiere moitié avec beaucoup de doublons pour que la seconde compte
+    myprint::boxedPrint("RadixSort<pair>", 20, 1);
+
+    std::vector<std::pair<int32_t, u32>> pairCollection;
+    for (int i = 0; i < initial_size; i++)
+        pairCollection.emplace_back((int32_t)(distribute(generator) % 64) - 32, distribute(generator));
+    std::vector<std::pair<int32_t, u32>> sortedPairs(pairCollection);
+    std::sort(sortedPairs.begin(), sortedPairs.end());
+    MyCollection<std::pair<int32_t, u32>> myPairCollection(pairCollection);
+    myPairCollection.shamble();
+
+    start = std::chrono::system_clock::now();
+
+    myPairCollection.radixSort();
+    orderCheck = myPairCollection.getCollection() == sortedPairs;
+    myPairCollection.shamble();
+    myPairCollection.radixSort(false);
+    orderCheck = orderCheck && myPairCollection.getCollection() == std::vector<std::pair<int32_t, u32>>(sortedPairs.rbegin(), sortedPairs.rend());
+
+    end = std::chrono::system_clock::now();
+
+    result_print.str(" "); // to clear the stream we need to replace the underlying string
+    elapsed_seconds = end - start;
+    result_print << "(" << orderCheck << ") Time Taken: " << elapsed_seconds.count() << "s";
+
+    myprint::boxedPrint(result_print.str());
+
+    // StringSort: préfixes communs plus longs que les 7 caractères lus d'un coup, chaînes préfixes d'autres, vide et octets > 127
+    myprint::boxedPrint("StringSort", 20, 1);
+
+    std::vector<std::string> urlCollection = {"", "https://www.example.com/items/", "https://www.example.com/items/\xff", "https://www.example.com/items/\x01"};
+    for (int i = 0; i < initial_size; i++)
+        urlCollection.emplace_back("https://www.example.com/items/" + std::to_string(distribute(generator) % 512));
+    std::vector<std::string> sortedUrls(urlCollection);
+    std::sort(sortedUrls.begin(), sortedUrls.end());
+    MyCollection<std::string> myUrlCollection(urlCollection);
+    myUrlCollection.shamble();
+
+    start = std::chrono::system_clock::now();
+
+    myUrlCollection.stringSort();
+    orderCheck = myUrlCollection.getCollection() == sortedUrls;
+    myUrlCollection.shamble();
+    myUrlCollection.stringSort(false);
+    orderCheck = orderCheck && myUrlCollection.getCollection() == std::vector<std::string>(sortedUrls.rbegin(), sortedUrls.rend());
+
+    end = std::chrono::system_clock::now();
+
+    result_print.str(" "); // to clear the stream we need to replace the underlying string
+    elapsed_seconds = end - start;
+    result_print << "(" << orderCheck << ") Time Taken: " << elapsed_seconds.count() << "s";
+
+    myprint::boxedPrint(result_print.str());
+
+    // Presortedness: l'analyse du constructeur sur des données triées, inversées, constantes et au hasard (taille fixe),
+    // puis setCollection qui doit refaire l'analyse pour que sort() ne prenne pas des données remplacées pour déja triées
+    myprint::boxedPrint("Presortedness", 20, 1);
+
+    int const analyzedSize = 4096;
+    std::vector<u32> ascendingValues, descendingValues, constantValues(analyzedSize, 42), randomValues;
+    for (int i = 0; i < analyzedSize; i++)
+    {
+        ascendingValues.push_back(i);
+        descendingValues.push_back(analyzedSize - i);
+    }
+    randomValues = ascendingValues;
+    std::shuffle(randomValues.begin(), randomValues.end(), generator);
+    long long randomDescents = 0;
+    for (int i = 1; i < analyzedSize; i++)
+        randomDescents += randomValues[i] < randomValues[i - 1];
+
+    start = std::chrono::system_clock::now();
+
+    MyCollection<u32> analyzed(ascendingValues);
+    Presortedness presortedness = analyzed.getPresortedness();
+    orderCheck = analyzed.isSorted() && analyzed.isAscending() && presortedness.ascending && !presortedness.descending && !presortedness.allEqual &&
+                 presortedness.runs == 1 && presortedness.reverseRuns == analyzedSize && presortedness.inversionRatio == 0;
+
+    analyzed.setCollection(descendingValues);
+    presortedness = analyzed.getPresortedness();
+    orderCheck = orderCheck && analyzed.isSorted() && !analyzed.isAscending() && !presortedness.ascending && presortedness.descending && !presortedness.allEqual &&
+                 presortedness.runs == analyzedSize && presortedness.reverseRuns == 1 && presortedness.inversionRatio == 1;
+
+    analyzed.setCollection(constantValues);
+    presortedness = analyzed.getPresortedness();
+    orderCheck = orderCheck && analyzed.isSorted() && presortedness.ascending && presortedness.descending && presortedness.allEqual &&
+                 presortedness.runs == 1 && presortedness.reverseRuns == 1 && presortedness.inversionRatio == 0;
+
+    analyzed.setCollection(ascendingValues);
+    analyzed.setCollection(randomValues); // données remplacées aprés une collection triée: plus de raccourci "already sorted"
+    presortedness = analyzed.getPresortedness();
+    orderCheck = orderCheck && !analyzed.isSorted() && !presortedness.ascending && !presortedness.descending && !presortedness.allEqual &&
+                 presortedness.runs == randomDescents + 1 && presortedness.reverseRuns == analyzedSize - randomDescents &&
+                 presortedness.inversionRatio > 0.3 && presortedness.inversionRatio < 0.7;
+    analyzed.sort();
+    orderCheck = orderCheck && analyzed.getCollection() == ascendingValues;
+
+    end = std::chrono::system_clock::now();
+
+    result_print.str(" "); // to clear the stream we need to replace the underlying string
+    elapsed_seconds = end - start;
+    result_print << "(" << orderCheck << ") Time Taken: " << elapsed_seconds.count() << "s";
+
+    myprint::boxedPrint(result_print.str());
+
+    // Sort: le tri est choisi selon la collection (seuils calibrés au premier appel)
+    myprint::boxedPrint("Sort", 20, 1);
+
+    mytestCollection.shamble();
+    sortConfig(); // la calibration de sort() (premier lancement seulement) ne doit pas compter dans le temps
+
+    start = std::chrono::system_clock::now();
+
+    mytestCollection.sort();
+    mytestCollection.shamble();
+    mytestCollection.sort(false);
+
+    end = std::chrono::system_clock::now();
+
+    orderCheck = checkingOrder(mytestCollection.getCollection(), initial_size, false);
+
+    result_print.str(" "); // to clear the stream we need to replace the underlying string
+    elapsed_seconds = end - start;
+    result_print << "(" << orderCheck << ") Time Taken: " << elapsed_seconds.count() << "s";
+
+    myprint::boxedPrint(result_print.str());
+
+    // Sort: comparateur en paramètre template
+    myprint::boxedPrint("Sort<Compare>", 20, 1);
+
+    mytestCollection.shamble();
+
+    start = std::chrono::system_clock::now();
+
+    mytestCollection.sort<Less>();
+    mytestCollection.shamble();
+    mytestCollection.sort<Greater>();
+
+    end = std::chrono::system_clock::now();
+
+    orderCheck = checkingOrder(mytestCollection.getCollection(), initial_size, false);
+
+    result_print.str(" "); // to clear the stream we need to replace the underlying string
+    elapsed_seconds = end - start;
+    result_print << "(" << orderCheck << ") Time Taken: " << elapsed_seconds.count() << "s";
+
+    myprint::boxedPrint(result_print.str());
+
+    // SortBy: clé attribut, méthode et lambda, dans les deux ordres
+    myprint::boxedPrint("SortBy", 20, 1);
+
+    std::vector<Person> people;
+    for (int i = 0; i < initial_size; i++)
+        people.push_back(Person{"person-" + std::to_string(distribute(generator)), distribute(generator) % 100, i});
+    std::vector<std::string> sortedNames;
+    for (Person const &person : people)
+        sortedNames.push_back(person.name);
+    std::sort(sortedNames.begin(), sortedNames.end());
+    MyCollection<Person> myPeople(people);
+    myPeople.shamble();
+
+    start = std::chrono::system_clock::now();
+
+    orderCheck = true;
+    myPeople.sortBy(&Person::age);
+    std::vector<Person> byAge = myPeople.getCollection();
+    myPeople.sortBy(&Person::age, Greater());
+    std::vector<Person> byAgeDescending = myPeople.getCollection();
+    for (int i = 1; i < initial_size; i++)
+        orderCheck = orderCheck && byAge[i - 1].age <= byAge[i].age && byAgeDescending[i - 1].age >= byAgeDescending[i].age;
+    myPeople.sortBy(&Person::getId);
+    std::vector<Person> byId = myPeople.getCollection();
+    myPeople.sortBy(&Person::getId, Greater());
+    std::vector<Person> byIdDescending = myPeople.getCollection();
+    for (int i = 0; i < initial_size; i++)
+        orderCheck = orderCheck && byId[i].id == i && byIdDescending[i].id == initial_size - 1 - i;
+    myPeople.sortBy([](Person const &person) -> std::string const & { return person.name; });
+    std::vector<Person> byName = myPeople.getCollection();
+    myPeople.sortBy([](Person const &person) -> std::string const & { return person.name; }, Greater());
+    std::vector<Person> byNameDescending = myPeople.getCollection();
+    for (int i = 0; i < initial_size; i++)
+        orderCheck = orderCheck && byName[i].name == sortedNames[i] && byNameDescending[i].name == sortedNames[initial_size - 1 - i];
+
+    end = std::chrono::system_clock::now();
+
+    result_print.str(" "); // to clear the stream we need to replace the underlying string
+    elapsed_seconds = end - start;
+    result_print << "(" << orderCheck << ") Time Taken: " << elapsed_seconds.count() << "s";
+
+    myprint::boxedPrint(result_print.str());
+
+    // ArgSort: la collection ne bouge pas, la permutation est appliquée avec gather
+    myprint::boxedPrint("ArgSort", 20, 1);
+
+    mytestCollection.shamble();
+
+    start = std::chrono::system_clock::now();
+
+    std::vector<uint32_t> permutation = mytestCollection.argSort(false);
+    std::vector<u32> gathered = gather(mytestCollection.getCollection(), permutation);
+
+    end = std::chrono::system_clock::now();
+
+    orderCheck = checkingOrder(gathered, initial_size, false);
+
+    result_print.str(" "); // to clear the stream we need to replace the underlying string
+    elapsed_seconds = end - start;
+    result_print << "(" << orderCheck << ") Time Taken: " << elapsed_seconds.count() << "s";
+
+    myprint::boxedPrint(result_print.str());
+
+    // SortWithPayload: le payload est la position d'origine de la clé, peu de clés distinctes pour vérifier la stabilité
+    myprint::boxedPrint("SortWithPayload", 20, 1);
+
+    std::vector<u32> payloadKeys;
+    for (int i = 0; i < initial_size; i++)
+        payloadKeys.emplace_back(distribute(generator) % 64);
+
+    start = std::chrono::system_clock::now();
+
+    orderCheck = true;
+    for (bool ascending : {true, false})
+    {
+        MyCollection<u32> myPayloadKeys(payloadKeys);
+        std::vector<int> rows;
+        for (int i = 0; i < initial_size; i++)
+            rows.emplace_back(i);
+        myPayloadKeys.sortWithPayload(rows, ascending);
+        std::vector<u32> const &keys = myPayloadKeys.getCollection();
+        orderCheck = orderCheck && checkingOrder(keys, initial_size, ascending) && (int)rows.size() == initial_size;
+        for (int i = 0; orderCheck && i < initial_size; i++)
+            orderCheck = payloadKeys[rows[i]] == keys[i] && (i == 0 || keys[i - 1] != keys[i] || rows[i - 1] < rows[i]);
+    }
+
+    end = std::chrono::system_clock::now();
+
+    result_print.str(" "); // to clear the stream we need to replace the underlying string
+    elapsed_seconds = end - start;
+    result_print << "(" << orderCheck << ") Time Taken: " << elapsed_seconds.count() << "s";
+
+    myprint::boxedPrint(result_print.str());
+
     // HeapSort
     myprint::boxedPrint("HeapSort", 20, 1);
 
@@ -193,6 +801,139 @@ int main(int argc, char *argv[])
 
     myprint::boxedPrint(result_print.str());
 
+    // Search: la collection est triée en ordre décroissant par le heapSort, puis en ordre croissant pour le second passage
+    myprint::boxedPrint("Search", 20, 1);
+
+    start = std::chrono::system_clock::now();
+
+    orderCheck = true;
+    for (bool ascending : {false, true})
+    {
+        if (ascending)
+            mytestCollection.heapSort();
+        std::vector<u32> sortedValues = mytestCollection.getCollection();
+        EytzingerIndex<u32> index = mytestCollection.buildIndex();
+        LearnedIndex<u32> learnedIndex = mytestCollection.buildLearnedIndex();
+        std::vector<u32> keys;
+        for (u32 value = 0; value <= (1 << 16); value += 97)
+            keys.push_back(value);
+        std::vector<int64_t> batch(keys.size()), sortedBatch(keys.size());
+        if (!ascending)
+            std::reverse(keys.begin(), keys.end()); // pour que sortKeys ait quelque chose à remettre en place
+        else
+            std::shuffle(keys.begin(), keys.end(), generator);
+        mytestCollection.searchBatch(keys.data(), keys.size(), batch.data());
+        mytestCollection.searchBatch(keys.data(), keys.size(), sortedBatch.data(), true);
+        orderCheck = orderCheck && batch == sortedBatch;
+        for (std::size_t i = 0; i < keys.size(); i++)
+            orderCheck = orderCheck && batch[i] == mytestCollection.binarySearch(keys[i]);
+        for (u32 value = 0; value <= (1 << 16); value += 97)
+        {
+            auto expected = ascending ? std::equal_range(sortedValues.begin(), sortedValues.end(), value, std::less<u32>())
+                                      : std::equal_range(sortedValues.begin(), sortedValues.end(), value, std::greater<u32>());
+            std::pair<int, int> range = mytestCollection.equalRange(value);
+            int found = mytestCollection.binarySearch(value);
+            int scanned = mytestCollection.normalSearch(value);
+            orderCheck = orderCheck && range.first == expected.first - sortedValues.begin() && range.second == expected.second - sortedValues.begin() &&
+                         mytestCollection.lowerBound(value) == range.first && mytestCollection.upperBound(value) == range.second &&
+                         found == (range.first < range.second ? range.first : -1) && scanned == found &&
+                         index.equalRange(value) == range && index.find(value) == found &&
+                         learnedIndex.equalRange(value) == range && learnedIndex.find(value) == found;
+        }
+    }
+
+    end = std::chrono::system_clock::now();
+
+    result_print.str(" "); // to clear the stream we need to replace the underlying string
+    elapsed_seconds = end - start;
+    result_print << "(" << orderCheck << ") Time Taken: " << elapsed_seconds.count() << "s";
+
+    myprint::boxedPrint(result_print.str());
+
+    // Selection: nthElement et percentiles sur une collection pas triée, comparés à la collection triée
+    myprint::boxedPrint("Selection", 20, 1);
+
+    mytestCollection.shamble();
+
+    start = std::chrono::system_clock::now();
+
+    std::vector<u32> expected = mytestCollection.getCollection();
+    std::sort(expected.begin(), expected.end());
+    std::vector<double> ps = {0, 50, 90, 99, 100};
+    std::vector<u32> values = mytestCollection.percentiles(ps);
+    orderCheck = initial_size < 2 || !mytestCollection.isSorted(); // une collection de moins de 2 elements est toujours triée
+    for (std::size_t i = 0; i < ps.size(); i++)
+        orderCheck = orderCheck && values[i] == expected[std::max(0, (int)std::ceil(ps[i] / 100 * initial_size) - 1)];
+    mytestCollection.shamble();
+    orderCheck = orderCheck && mytestCollection.nthElement(initial_size / 3) == expected[initial_size / 3] &&
+                 mytestCollection.nthElement(0, false) == expected[initial_size - 1] && mytestCollection.percentile(50) == values[1];
+
+    end = std::chrono::system_clock::now();
+
+    result_print.str(" "); // to clear the stream we need to replace the underlying string
+    elapsed_seconds = end - start;
+    result_print << "(" << orderCheck << ") Time Taken: " << elapsed_seconds.count() << "s";
+
+    myprint::boxedPrint(result_print.str());
+
+    // TopK: la collection lue comme un flux, par morceaux, comparée à la fin de la collection triée (expected de Selection)
+    myprint::boxedPrint("TopK", 20, 1);
+
+    start = std::chrono::system_clock::now();
+
+    int const k = std::min(100, initial_size);
+    TopK<u32> top(k), bottom(k, false);
+    std::vector<u32> stream = mytestCollection.getCollection();
+    int position = 0;
+    top.pull([&stream, &position](u32 *buffer, int capacity)
+             {
+                 int count = std::min(capacity, (int)stream.size() - position);
+                 std::copy(stream.begin() + position, stream.begin() + position + count, buffer);
+                 position += count;
+                 return count; });
+    bottom.push(stream.begin(), stream.end());
+
+    end = std::chrono::system_clock::now();
+
+    std::vector<u32> largest = top.result(), smallest = bottom.result();
+    orderCheck = largest.size() == (std::size_t)k && std::equal(largest.begin(), largest.end(), expected.rbegin()) &&
+                 smallest.size() == (std::size_t)k && std::equal(smallest.begin(), smallest.end(), expected.begin());
+
+    result_print.str(" "); // to clear the stream we need to replace the underlying string
+    elapsed_seconds = end - start;
+    result_print << "(" << orderCheck << ") Time Taken: " << elapsed_seconds.count() << "s";
+
+    myprint::boxedPrint(result_print.str());
+
+    // MergeFrom: la collection coupée en 8 shards triés dans un ordre ou dans l'autre, puis mergés (k-way puis deux shards)
+    myprint::boxedPrint("MergeFrom", 20, 1);
+
+    std::vector<MyCollection<u32>> shards;
+    for (int shard = 0; shard < 8; shard++)
+    {
+        std::vector<u32> part(stream.begin() + (long long)initial_size * shard / 8, stream.begin() + (long long)initial_size * (shard + 1) / 8);
+        shards.emplace_back(part);
+        shards.back().radixSort(shard % 2 == 0);
+    }
+
+    start = std::chrono::system_clock::now();
+
+    mytestCollection.mergeFrom(shards);
+    orderCheck = mytestCollection.getCollection() == expected;
+    shards.erase(shards.begin(), shards.end() - 2); // les deux derniers shards: le dernier n'est jamais vide, même pour une collection de moins de 8 elements
+    mytestCollection.mergeFromParallel(shards, false);
+    std::vector<u32> merged = mytestCollection.getCollection();
+    orderCheck = orderCheck && merged.size() == shards[0].getCollection().size() + shards[1].getCollection().size() &&
+                 std::is_sorted(merged.rbegin(), merged.rend());
+
+    end = std::chrono::system_clock::now();
+
+    result_print.str(" "); // to clear the stream we need to replace the underlying string
+    elapsed_seconds = end - start;
+    result_print << "(" << orderCheck << ") Time Taken: " << elapsed_seconds.count() << "s";
+
+    myprint::boxedPrint(result_print.str());
+
     std::cout << "Main end" << std::endl;
 
     return 0;
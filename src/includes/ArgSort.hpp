@@ -0,0 +1,83 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include "RadixKey.hpp"
+#include "RadixSort.hpp"
+
+namespace mycollections
+{
+    /**
+     * Une paire (clé radix, index) compacte: pour des u32 avec des index u32 c'est 8 octets par element.
+     * La clé est encodée (RadixKey<T>::encode, ordre décroissant compris) une seule fois, à la construction des paires.
+     */
+    template <typename Key, typename Index>
+    struct KeyIndex
+    {
+        Key key;
+        Index index;
+    };
+
+    /**
+     * Les radix sorts ne regardent que la clé: le LSD étant stable, les paires de même clé restent dans l'ordre des index.
+     */
+    template <typename Key, typename Index>
+    struct RadixKey<KeyIndex<Key, Index>>
+    {
+        static const bool sortable = true;
+        using Unsigned = Key;
+
+        static Unsigned encode(KeyIndex<Key, Index> const &value, bool const)
+        {
+            return value.key;
+        }
+    };
+
+    /**
+     * Argsort sans comparaison: les paires (clé, index) sont triées par radix sort LSD sur les bits de la clé seulement,
+     * les comparaisons ne passent jamais par un index (pas d'accés indirect à la collection pendant le tri).
+     * @param permutation size index, permutation[i] est l'index dans array du i-ème element trié. Stable.
+     */
+    template <typename T, typename Index>
+    void argSortRadix(T const *const array, int const size, bool const descending, Index *const permutation)
+    {
+        using Key = typename RadixKey<T>::Unsigned;
+        std::vector<KeyIndex<Key, Index>> pairs(size), buffer(size);
+        for (int i = 0; i < size; i++)
+        {
+            pairs[i].key = RadixKey<T>::encode(array[i], descending);
+            pairs[i].index = (Index)i;
+        }
+        radixSortLSD(&pairs[0], &buffer[0], size, false);
+        for (int i = 0; i < size; i++)
+            permutation[i] = pairs[i].index;
+    }
+
+    /**
+     * Applique une permutation (le résultat d'un argSort) à une autre colonne: result[i] = column[permutation[i]].
+     * Les colonnes parallèles (timestamps, ids, payloads...) se retrouvent dans l'ordre de la colonne triée
+     * sans que leurs lignes soient déplacées pendant le tri.
+     */
+    template <typename V, typename Index>
+    std::vector<V> gather(std::vector<V> const &column, std::vector<Index> const &permutation)
+    {
+        std::vector<V> result;
+        result.reserve(permutation.size());
+        for (std::size_t i = 0; i < permutation.size(); i++)
+            result.push_back(column[permutation[i]]);
+        return result;
+    }
+
+    /**
+     * Comme gather mais la colonne est réordonnée: ses elements sont déplacés (std::move, pas de copie) dans l'ordre de la permutation,
+     * en un seul passage (lecture aux index de la permutation, écriture séquentielle) vers un tableau qui remplace ensuite column.
+     */
+    template <typename V, typename Index>
+    void permute(std::vector<V> &column, std::vector<Index> const &permutation)
+    {
+        std::vector<V> result;
+        result.reserve(permutation.size());
+        for (std::size_t i = 0; i < permutation.size(); i++)
+            result.push_back(std::move(column[permutation[i]]));
+        column.swap(result);
+    }
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include <iostream>
+#include <cstdlib>
+
+/**
+ * Bornes vérifiées (MYCOLLECTION_CHECK_BOUNDS, voir l'option du même nom dans CMakeLists.txt): les boucles de partition et de merge
+ * travaillent sur des pointeurs et des index sans .at(), et les plus risquées (boucles non gardées des partitions, positions calculées
+ * par co-rank, pile du quickSort, buckets de sampleSort, suites du merge k-way) vérifient ici chaque position lue ou écrite.
+ * En mode normal la macro ne génère rien.
+ */
+#ifdef MYCOLLECTION_CHECK_BOUNDS
+#define MYCOLLECTION_CHECK_RANGE(position, begin, end) mycollections::checkRange((position), (begin), (end), #position, __FILE__, __LINE__)
+#else
+#define MYCOLLECTION_CHECK_RANGE(position, begin, end) ((void)0)
+#endif
+
+namespace mycollections
+{
+    // begin <= position < end (index ou pointeurs), sinon arrêt du programme avec la position fautive
+    template <typename Position, typename Bound>
+    void checkRange(Position const position, Bound const begin, Bound const end, char const *const name, char const *const file, int const line)
+    {
+        if (position < begin || !(position < end))
+        {
+            std::cerr << "MyCollection: " << name << " is out of range at " << file << ":" << line << "!" << std::endl;
+            std::abort();
+        }
+    }
+}
@@ -0,0 +1,185 @@
+#pragma once
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <functional>
+
+namespace mycollections
+{
+    /**
+     * Index de recherche en lecture seule, construit à partir d'une collection triée (MyCollection::buildIndex()).
+     * Les elements sont rangés dans l'ordre d'un parcours en largeur de l'arbre binaire de recherche (disposition d'Eytzinger):
+     * les enfants de tree[k] sont tree[2k] et tree[2k + 1], les premiers niveaux tiennent dans quelques lignes de cache
+     * et les 16 descendants de tree[k] à 4 niveaux (pour des elements de 4 octets) sont dans une seule ligne, chargée pendant qu'on descend.
+     * Les recherches retournent des positions dans la collection triée au moment de la construction (calculées à partir de l'indice dans tree,
+     * sans tableau de positions): l'index garde sa propre copie
+     * des elements et n'est pas touché par les tris suivants de la collection.
+     */
+    template <typename T>
+    class EytzingerIndex
+    {
+    public:
+        EytzingerIndex() : tree(1), descending(false), levels(0), fullLevels(0) {}
+        EytzingerIndex(T const *const sorted, int const size, bool const ascending);
+
+        int size() const { return this->tree.size() - 1; }
+
+        // mêmes résultats que MyCollection::lowerBound, upperBound, equalRange et binarySearch sur la collection triée
+        int lowerBound(T const &value) const;
+        int upperBound(T const &value) const;
+        std::pair<int, int> equalRange(T const &value) const;
+        int find(T const &value) const; // position du premier element égal à value, -1 si absent
+
+    private:
+        std::vector<T> tree; // tree[1..size], tree[0] n'est pas utilisé
+        bool descending;
+        int levels;     // nombre de niveaux de l'arbre
+        int fullLevels; // nombre de niveaux complets, le dernier peut ne pas l'être
+
+        static int floorLog2(unsigned long long const x);
+
+        int fill(T const *const sorted, int next, int const k);
+        template <typename Before>
+        int descend(Before before) const;
+        int position(int const k) const;
+    };
+
+    template <typename T>
+    EytzingerIndex<T>::EytzingerIndex(T const *const sorted, int const size, bool const ascending)
+        : tree(size + 1), descending(!ascending), levels(size == 0 ? 0 : floorLog2(size) + 1), fullLevels(floorLog2(size + 1))
+    {
+        fill(sorted, 0, 1);
+    }
+
+    template <typename T>
+    int EytzingerIndex<T>::floorLog2(unsigned long long const x)
+    {
+#if defined(__GNUC__)
+        return 63 - __builtin_clzll(x);
+#else
+        int log = 0;
+        while ((x >> log) > 1)
+            log++;
+        return log;
+#endif
+    }
+
+    /**
+     * Parcours infixe de l'arbre implicite: le sous arbre gauche de k reçoit les elements avant celui de k, le droit ceux d'aprés.
+     * La récursion ne descend que de log2(size) niveaux.
+     * @return l'index dans sorted du prochain element à placer
+     */
+    template <typename T>
+    int EytzingerIndex<T>::fill(T const *const sorted, int next, int const k)
+    {
+        if (k <= size())
+        {
+            next = fill(sorted, next, 2 * k);
+            this->tree[k] = sorted[next];
+            next = fill(sorted, next + 1, 2 * k + 1);
+        }
+        return next;
+    }
+
+    /**
+     * Descente sans branchement: k = 2k + before(tree[k]). Le chemin se termine par un virage à droite (before vrai) pour chaque
+     * niveau sous la réponse, les bits à 1 de poids faible de k puis le 0 du dernier virage à gauche sont retirés pour la retrouver.
+     * Le nombre de tours ne dépend que de la taille (les niveaux complets puis un pas conditionnel sur le dernier): la sortie de boucle
+     * est toujours bien prédite et le processeur peut commencer la recherche suivante pendant les défauts de cache de celle-ci.
+     * @return l'indice dans tree du premier element pour lequel before est faux, 0 s'il n'y en a pas
+     */
+    template <typename T>
+    template <typename Before>
+    int EytzingerIndex<T>::descend(Before before) const
+    {
+        // les descendants de k à 4 niveaux (16 * k) quand 16 elements tiennent dans une ligne de 64 octets
+        int const prefetchStride = sizeof(T) >= 64 ? 1 : 64 / sizeof(T);
+        int const last = size();
+        T const *const data = this->tree.data();
+        unsigned long long k = 1;
+        for (int level = 0; level < this->fullLevels; level++)
+        {
+#if defined(__GNUC__)
+            __builtin_prefetch(data + std::min<unsigned long long>(k * prefetchStride, last));
+#endif
+            k = 2 * k + before(data[k]);
+        }
+        // dernier niveau incomplet: un pas de plus seulement si le noeud existe (sinon tree[0] est lu et le résultat ignoré)
+        unsigned long long const exists = k <= (unsigned long long)last;
+        unsigned long long const next = 2 * k + before(data[k * exists]);
+        k = exists ? next : k;
+#if defined(__GNUC__)
+        k >>= __builtin_ffsll(~k);
+#else
+        while (k & 1)
+            k >>= 1;
+        k >>= 1;
+#endif
+        return (int)k;
+    }
+
+    /**
+     * Position de tree[k] dans la collection triée, calculée sans accés mémoire (un tableau de positions coûterait un défaut de cache
+     * de plus par recherche). Dans l'arbre parfait à levels niveaux, le i-ème noeud de profondeur d a le rang infixe (2i + 1) * 2^(levels - 1 - d) - 1
+     * et les feuilles du dernier niveau ont les rangs pairs: on retire les feuilles absentes (au delà des present premières) qui passent avant k.
+     * @return size() pour k = 0 (aucun element ne convient)
+     */
+    template <typename T>
+    int EytzingerIndex<T>::position(int const k) const
+    {
+        if (k == 0)
+            return size();
+        int const depth = floorLog2(k);
+        long long const levelIndex = k - (1LL << depth);
+        long long const perfectRank = ((2 * levelIndex + 1) << (this->levels - 1 - depth)) - 1;
+        long long const present = size() - ((1LL << (this->levels - 1)) - 1); // feuilles du dernier niveau
+        long long const leavesBefore = (perfectRank + 1) / 2;
+        return perfectRank - std::max(0LL, leavesBefore - present);
+    }
+
+    template <typename T>
+    int EytzingerIndex<T>::lowerBound(T const &value) const
+    {
+        if (this->descending)
+            return position(descend([&value](T const &element)
+                                    { return std::greater<T>()(element, value); }));
+        return position(descend([&value](T const &element)
+                                { return std::less<T>()(element, value); }));
+    }
+
+    template <typename T>
+    int EytzingerIndex<T>::upperBound(T const &value) const
+    {
+        if (this->descending)
+            return position(descend([&value](T const &element)
+                                    { return !std::greater<T>()(value, element); }));
+        return position(descend([&value](T const &element)
+                                { return !std::less<T>()(value, element); }));
+    }
+
+    template <typename T>
+    std::pair<int, int> EytzingerIndex<T>::equalRange(T const &value) const
+    {
+        return std::make_pair(lowerBound(value), upperBound(value));
+    }
+
+    template <typename T>
+    int EytzingerIndex<T>::find(T const &value) const
+    {
+        int k;
+        bool found;
+        if (this->descending)
+        {
+            k = descend([&value](T const &element)
+                        { return std::greater<T>()(element, value); });
+            found = k != 0 && !std::greater<T>()(value, this->tree[k]);
+        }
+        else
+        {
+            k = descend([&value](T const &element)
+                        { return std::less<T>()(element, value); });
+            found = k != 0 && !std::less<T>()(value, this->tree[k]);
+        }
+        return found ? position(k) : -1;
+    }
+}
@@ -0,0 +1,203 @@
+#pragma once
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <cstddef>
+#include "Parallel.hpp"
+#include "Search.hpp"
+#include "SimdSort.hpp"
+#include "BoundsCheck.hpp"
+
+namespace mycollections
+{
+    // une suite triée (selon le comparateur du merge) à merger: [begin, end)
+    template <typename T>
+    struct SortedRun
+    {
+        T const *begin;
+        T const *end;
+        int size() const { return end - begin; }
+    };
+
+    /**
+     * Arbre des perdants (tournoi) sur k suites: chaque noeud interne garde le perdant du match joué chez lui, tree[0] le gagnant.
+     * Aprés avoir écrit le gagnant, seul le chemin de sa feuille à la racine est rejoué: log2(k) comparaisons par element,
+     * contre k - 1 pour chercher le plus petit des k à chaque fois.
+     * Stable: à égalité la suite d'index le plus petit gagne, les elements égaux sortent dans l'ordre des suites.
+     */
+    template <typename T, typename Compare>
+    class LoserTree
+    {
+    public:
+        LoserTree(std::vector<SortedRun<T>> const &runs, Compare comp) : runs(runs), tree(std::max<std::size_t>(1, runs.size())), comp(comp)
+        {
+            int const k = this->runs.size();
+            this->tree[0] = k > 1 ? build(1) : 0;
+        }
+
+        // écrit les count elements suivants dans out (count <= nombre d'elements restants)
+        void mergeInto(T *out, std::size_t count);
+
+    private:
+        std::vector<SortedRun<T>> runs; // begin avance à chaque element écrit
+        std::vector<int> tree;          // tree[1..k-1] les perdants, les feuilles k..2k-1 sont les suites (implicites)
+        Compare comp;
+
+        // une suite vide perd toujours, sinon une seule comparaison: la suite d'index le plus petit gagne sauf si l'autre passe strictement avant
+        bool beats(int const a, int const b) const
+        {
+            if (this->runs[a].begin == this->runs[a].end)
+                return false;
+            if (this->runs[b].begin == this->runs[b].end)
+                return true;
+            T const &x = *this->runs[a].begin, &y = *this->runs[b].begin;
+            return a < b ? !this->comp(y, x) : this->comp(x, y);
+        }
+
+        // joue les matchs du sous arbre de node, @return le gagnant
+        int build(int const node)
+        {
+            int const k = this->runs.size();
+            if (node >= k)
+                return node - k;
+            int const left = build(2 * node), right = build(2 * node + 1);
+            bool const leftWins = beats(left, right);
+            this->tree[node] = leftWins ? right : left;
+            return leftWins ? left : right;
+        }
+    };
+
+    template <typename T, typename Compare>
+    void LoserTree<T, Compare>::mergeInto(T *out, std::size_t count)
+    {
+        int const k = this->runs.size();
+        for (; count > 0; count--)
+        {
+            int winner = this->tree[0];
+            MYCOLLECTION_CHECK_RANGE(this->runs[winner].begin, this->runs[winner].begin, this->runs[winner].end); // pas de suite épuisée
+            *out++ = *this->runs[winner].begin++;
+            for (int node = (winner + k) / 2; node > 0; node /= 2)
+                if (beats(this->tree[node], winner))
+                    std::swap(this->tree[node], winner);
+            this->tree[0] = winner;
+        }
+    }
+
+    /**
+     * Merge de k suites dans out. Chemins rapides pour 1 suite (copie) et 2 suites: merge bitonique SIMD pour les types de 32 bits
+     * (voir SimdSort.hpp), sinon une boucle où l'element choisi est écrit sans branchement. L'arbre des perdants au delà.
+     */
+    template <typename T, typename Compare>
+    void kWayMerge(std::vector<SortedRun<T>> const &runs, T *out, Compare comp)
+    {
+        if (runs.size() == 1)
+        {
+            std::copy(runs[0].begin, runs[0].end, out);
+            return;
+        }
+        if (runs.size() == 2)
+        {
+            T const *left = runs[0].begin, *right = runs[1].begin;
+            T const *const leftEnd = runs[0].end, *const rightEnd = runs[1].end;
+            if (SimdSort<T, Compare>::enabled && SimdSort<T, Compare>::merge(left, leftEnd - left, right, rightEnd - right, out, comp))
+                return;
+            while (left < leftEnd && right < rightEnd)
+            {
+                bool const takeRight = comp(*right, *left);
+                *out++ = takeRight ? *right : *left;
+                right += takeRight;
+                left += !takeRight;
+            }
+            out = std::copy(left, leftEnd, out);
+            std::copy(right, rightEnd, out);
+            return;
+        }
+        if (runs.size() > 2)
+        {
+            std::size_t total = 0;
+            for (SortedRun<T> const &run : runs)
+                total += run.size();
+            LoserTree<T, Compare>(runs, comp).mergeInto(out, total);
+        }
+    }
+
+    /**
+     * Sélection multi-suites: combien d'elements prendre dans chaque suite pour avoir les rank premiers elements du merge (stable).
+     * L'element de rang rank est (x, j) avec x = runs[j][p]: avant lui viennent p elements de sa suite, les elements <= x des suites
+     * d'avant et les elements < x des suites d'aprés. Ce rang croit avec p, une recherche binaire dans chaque suite trouve la seule qui le contient.
+     * O(k² * log²(n)), négligeable devant le merge pour quelques découpes.
+     */
+    template <typename T, typename Compare>
+    std::vector<int> multiwaySplit(std::vector<SortedRun<T>> const &runs, std::size_t const rank, Compare comp)
+    {
+        int const k = runs.size();
+        std::vector<int> splits(k);
+        for (int j = 0; j < k; j++)
+        {
+            // rang de runs[j][p], splits rempli avec les positions qui le donnent
+            auto rankOf = [&](int const p)
+            {
+                T const &x = runs[j].begin[p];
+                std::size_t before = 0;
+                for (int i = 0; i < k; i++)
+                {
+                    if (i == j)
+                        splits[i] = p;
+                    else if (i < j)
+                        splits[i] = upperBound(runs[i].begin, runs[i].size(), x, comp);
+                    else
+                        splits[i] = lowerBound(runs[i].begin, runs[i].size(), x, comp);
+                    before += splits[i];
+                }
+                return before;
+            };
+            int low = 0, high = runs[j].size();
+            while (low < high)
+            {
+                int const mid = low + (high - low) / 2;
+                if (rankOf(mid) < rank)
+                    low = mid + 1;
+                else
+                    high = mid;
+            }
+            if (low < runs[j].size() && rankOf(low) == rank)
+                return splits;
+        }
+        // rank est le nombre total d'elements: tout prendre
+        for (int i = 0; i < k; i++)
+            splits[i] = runs[i].size();
+        return splits;
+    }
+
+    /**
+     * Chaque thread produit une tranche égale de out: les bornes de sa tranche sont découpées dans toutes les suites
+     * par multiwaySplit, puis il merge ses morceaux de suites avec kWayMerge. Même résultat que kWayMerge.
+     */
+    template <typename T, typename Compare>
+    void kWayMergeParallel(std::vector<SortedRun<T>> const &runs, T *out, int threads, Compare comp)
+    {
+        std::size_t total = 0;
+        for (SortedRun<T> const &run : runs)
+            total += run.size();
+        threads = effectiveThreads(threads, total);
+        if (threads <= 1 || runs.size() < 2)
+        {
+            kWayMerge(runs, out, comp);
+            return;
+        }
+
+        std::vector<std::vector<int>> splits(threads + 1);
+        for (int t = 0; t <= threads; t++)
+            splits[t] = multiwaySplit(runs, total * t / threads, comp);
+        parallelFor(threads, [&](int t)
+                    {
+                        std::vector<SortedRun<T>> pieces;
+                        for (std::size_t i = 0; i < runs.size(); i++)
+                        {
+                            MYCOLLECTION_CHECK_RANGE(splits[t + 1][i], splits[t][i], runs[i].size() + 1);
+                            if (splits[t][i] < splits[t + 1][i])
+                                pieces.push_back(SortedRun<T>{runs[i].begin + splits[t][i], runs[i].begin + splits[t + 1][i]});
+                        }
+                        kWayMerge(pieces, out + total * t / threads, comp); });
+    }
+}
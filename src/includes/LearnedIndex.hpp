@@ -0,0 +1,208 @@
+#pragma once
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <functional>
+#include <type_traits>
+#include "Search.hpp"
+
+namespace mycollections
+{
+    // nombre moyen de clés par feuille du modèle quand buildLearnedIndex() ne reçoit pas de nombre de feuilles
+    const int LEARNED_INDEX_LEAF_SIZE = 256;
+    // fenêtre (en elements) jusqu'à laquelle la fin de la recherche est un comptage SIMD, au delà une recherche binaire dans la fenêtre
+    const int LEARNED_INDEX_SCAN = 64;
+
+    /**
+     * Index appris en lecture seule pour des clés numériques, construit à partir d'une collection triée (MyCollection::buildLearnedIndex()).
+     * Modèle à deux niveaux (RMI): une interpolation linéaire sur [min, max] choisit une feuille, chaque feuille interpole la position
+     * entre sa premiere et sa dernière clé et garde les erreurs min et max de cette prédiction sur ses clés.
+     * La réponse est toujours dans la fenêtre [prédiction + erreur min, prédiction + erreur max] bornée à la feuille:
+     * comptage SIMD si elle est petite (données presque uniformes), recherche binaire dans la fenêtre sinon.
+     * Comme EytzingerIndex, l'index garde sa propre copie des clés (en ordre croissant) et retourne les positions de la collection triée.
+     */
+    template <typename T>
+    class LearnedIndex
+    {
+        static_assert(std::is_arithmetic<T>::value, "LearnedIndex needs numeric keys");
+
+    public:
+        LearnedIndex() : descending(false) {}
+        LearnedIndex(T const *const sorted, int const size, bool const ascending, int leafCount = 0);
+
+        int size() const { return this->keys.size(); }
+
+        // mêmes résultats que MyCollection::lowerBound, upperBound, equalRange et binarySearch sur la collection triée
+        int lowerBound(T const &value) const;
+        int upperBound(T const &value) const;
+        std::pair<int, int> equalRange(T const &value) const;
+        int find(T const &value) const; // position du premier element égal à value, -1 si absent
+
+        // pour choisir entre cet index et les autres recherches: taille du modèle en octets (sans la copie des clés)
+        // et plus grand écart entre la position prédite et la vraie position d'une clé
+        std::size_t modelSize() const { return sizeof(*this) + this->leaves.size() * sizeof(Leaf); }
+        int maxError() const;
+
+    private:
+        struct Leaf
+        {
+            double origin;  // premiere clé de la feuille
+            double slope;   // positions par unité de clé
+            int start, end; // positions de la feuille: [start, end)
+            int minError, maxError;
+        };
+
+        std::vector<T> keys; // croissant, même si la collection était triée en ordre décroissant
+        std::vector<Leaf> leaves;
+        double rootOrigin = 0;
+        double rootSlope = 0;
+        bool descending;
+
+        int leafOf(T const &value) const;
+        static long long predict(Leaf const &leaf, T const &value);
+        // dans keys croissant: premier index dont la clé n'est pas < value (strict) ou pas <= value
+        int search(T const &value, bool const strict) const;
+        void fit(Leaf &leaf) const;
+    };
+
+    template <typename T>
+    LearnedIndex<T>::LearnedIndex(T const *const sorted, int const size, bool const ascending, int leafCount)
+        : keys(sorted, sorted + size), descending(!ascending)
+    {
+        if (this->descending)
+            std::reverse(this->keys.begin(), this->keys.end());
+        if (size == 0)
+            return;
+        if (leafCount <= 0)
+            leafCount = size / LEARNED_INDEX_LEAF_SIZE + 1;
+
+        double const low = this->keys.front(), high = this->keys.back();
+        this->rootOrigin = low;
+        this->rootSlope = high > low ? leafCount / (high - low) : 0;
+
+        // leafOf est croissant: les clés de chaque feuille sont contiguës dans keys
+        this->leaves.resize(leafCount);
+        int position = 0;
+        for (int leaf = 0; leaf < leafCount; leaf++)
+        {
+            this->leaves[leaf].start = position;
+            while (position < size && leafOf(this->keys[position]) == leaf)
+                position++;
+            this->leaves[leaf].end = position;
+            fit(this->leaves[leaf]);
+        }
+    }
+
+    template <typename T>
+    int LearnedIndex<T>::leafOf(T const &value) const
+    {
+        double const leaf = ((double)value - this->rootOrigin) * this->rootSlope;
+        return std::max(0.0, std::min(leaf, (double)this->leaves.size() - 1));
+    }
+
+    // arrondi et borné à la feuille: croissant en value, la même fonction sert à mesurer les erreurs et à chercher
+    template <typename T>
+    long long LearnedIndex<T>::predict(Leaf const &leaf, T const &value)
+    {
+        double const position = leaf.start + ((double)value - leaf.origin) * leaf.slope;
+        return std::max<double>(leaf.start, std::min<double>(position, leaf.end));
+    }
+
+    /**
+     * Interpolation entre la premiere clé et la dernière (position de sa premiere occurrence), puis les erreurs de cette prédiction:
+     * pour chaque clé distincte, sa premiere position et la position aprés sa dernière occurrence.
+     * Une valeur absente entre deux clés a et b de la feuille a sa réponse aprés a et avant b, et la prédiction est croissante:
+     * les erreurs sur les clés bornent donc aussi les valeurs absentes.
+     */
+    template <typename T>
+    void LearnedIndex<T>::fit(Leaf &leaf) const
+    {
+        leaf.minError = leaf.maxError = 0;
+        leaf.origin = leaf.slope = 0;
+        if (leaf.start == leaf.end)
+            return;
+
+        T const *const data = this->keys.data();
+        int lastFirst = leaf.end - 1; // premiere occurrence de la dernière clé
+        while (lastFirst > leaf.start && data[lastFirst - 1] == data[leaf.end - 1])
+            lastFirst--;
+        leaf.origin = data[leaf.start];
+        double const span = (double)data[leaf.end - 1] - leaf.origin;
+        leaf.slope = span > 0 ? (lastFirst - leaf.start) / span : 0;
+
+        leaf.minError = leaf.end - leaf.start;
+        leaf.maxError = -leaf.minError;
+        for (int first = leaf.start; first < leaf.end;)
+        {
+            int next = first + 1;
+            while (next < leaf.end && data[next] == data[first])
+                next++;
+            long long const predicted = predict(leaf, data[first]);
+            leaf.minError = std::min<long long>(leaf.minError, first - predicted);
+            leaf.maxError = std::max<long long>(leaf.maxError, next - predicted);
+            first = next;
+        }
+    }
+
+    template <typename T>
+    int LearnedIndex<T>::maxError() const
+    {
+        int error = 0;
+        for (Leaf const &leaf : this->leaves)
+            error = std::max(error, std::max(-leaf.minError, leaf.maxError));
+        return error;
+    }
+
+    template <typename T>
+    int LearnedIndex<T>::search(T const &value, bool const strict) const
+    {
+        if (this->leaves.empty())
+            return 0;
+        Leaf const &leaf = this->leaves[leafOf(value)];
+        long long const predicted = predict(leaf, value);
+        int const first = std::max<long long>(leaf.start, predicted + leaf.minError);
+        int const last = std::min<long long>(leaf.end, predicted + leaf.maxError);
+        if (first >= last)
+            return first;
+
+        T const *const window = this->keys.data() + first;
+        int const length = last - first;
+        if (length <= LEARNED_INDEX_SCAN)
+            return first + (strict ? countLess(window, length, value) : length - countGreater(window, length, value));
+        if (strict)
+            return first + mycollections::lowerBound(window, length, value, std::less<T>());
+        return first + mycollections::upperBound(window, length, value, std::less<T>());
+    }
+
+    /**
+     * En ordre décroissant les elements qui passent avant value sont ceux > value: size - upperBound croissant, de même pour upperBound.
+     */
+    template <typename T>
+    int LearnedIndex<T>::lowerBound(T const &value) const
+    {
+        if (this->descending)
+            return size() - search(value, false);
+        return search(value, true);
+    }
+
+    template <typename T>
+    int LearnedIndex<T>::upperBound(T const &value) const
+    {
+        if (this->descending)
+            return size() - search(value, true);
+        return search(value, false);
+    }
+
+    template <typename T>
+    std::pair<int, int> LearnedIndex<T>::equalRange(T const &value) const
+    {
+        return std::make_pair(lowerBound(value), upperBound(value));
+    }
+
+    template <typename T>
+    int LearnedIndex<T>::find(T const &value) const
+    {
+        std::pair<int, int> const range = equalRange(value);
+        return range.first < range.second ? range.first : -1;
+    }
+}
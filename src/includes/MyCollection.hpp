@@ -4,7 +4,25 @@
 #include <random>
 #include <cctype>
 #include <cmath> // pour le log2 du quicksort (C11 nécessaire)
+#include <algorithm>
+#include <functional>
+#include <limits>
 #include "PrettyPrinting.hpp"
+#include "Parallel.hpp"
+#include "SampleSort.hpp"
+#include "RadixSort.hpp"
+#include "StringSort.hpp"
+#include "TimSort.hpp"
+#include "Ordering.hpp"
+#include "Presortedness.hpp"
+#include "ArgSort.hpp"
+#include "SortConfig.hpp"
+#include "SimdSort.hpp"
+#include "Search.hpp"
+#include "EytzingerIndex.hpp"
+#include "LearnedIndex.hpp"
+#include "KWayMerge.hpp"
+#include "BoundsCheck.hpp"
 
 namespace mycollections
 {
@@ -13,25 +31,135 @@ namespace mycollections
     using u32 = uint_least32_t; // u32 is the smallest datatype supported by the system that can hold at least 32 bits
     using engine = std::mt19937;
 
+    // en dessous de cette taille un insertion sort est plus rapide que de continuer à diviser
+    const int SMALL_RANGE_CUTOFF = 16;
+    // countingSort n'est utilisé que si max - min + 1 <= COUNTING_SORT_RANGE_FACTOR * taille de la collection
+    const int COUNTING_SORT_RANGE_FACTOR = 1;
+    // nombre d'elements comparés d'un coup de chaque coté par blockQuickSort, les offsets tiennent sur un unsigned char
+    const int PARTITION_BLOCK_SIZE = 64;
+
     template <typename T>
     class MyCollection
     {
     private:
+        // argSort trie des index avec les fonctions de MyCollection<Index>
+        template <typename U>
+        friend class MyCollection;
+        // la calibration de sort() mesure les fonctions de tri privées
+        friend class SortCalibration;
+        // TopK garde ses k elements dans le tas de heapSort
+        template <typename U>
+        friend class TopK;
+
         bool sorted;
         bool ascending;
         std::vector<T> collection;
 
-        // For mergeSort
-        void trueMergeSortRecursiveAscending(T *const collection, int const midpoint, int const end);
-        void trueMergeSortRecursiveDescending(T *const collection, int const midpoint, int const end);
+        // état de la collection au constructeur ou au dernier setCollection (voir Presortedness.hpp)
+        Presortedness presortedness;
+        bool presortednessCurrent; // false dés que la collection a changé sans être triée (shamble, sortBy...)
+
+        // vérifie si la collection est déja triée, choisi à la compilation selon que T a les opérateurs < et > ou pas
+        void checkOrder(int threads, std::true_type);
+        void checkOrder(int threads, std::false_type);
+
+        // For mergeSort: un seul buffer, les niveaux alternent entre la collection et le buffer
+        template <typename Compare>
+        static void mergeSplitPingPong(T *const source, T *const destination, int const start, int const end, Compare comp);
+        template <typename Compare>
+        static void mergeBottomUp(T *const collection, T *const buffer, int const size, Compare comp);
+        template <typename Compare>
+        static void mergeRuns(T *const source, T *const destination, int const start, int const midpoint, int const end, Compare comp);
+
+        // For mergeSortParallel: chaque thread produit un segment de la sortie d'un niveau de merge
+        template <typename Compare>
+        static void levelCoRanks(T *const source, std::vector<int> const &bounds, int const out, std::vector<int> &leftTaken, Compare comp);
+        template <typename Compare>
+        static void mergeLevelSegment(T *const source, T *const destination, std::vector<int> const &bounds, int const outBegin, int const outEnd,
+                                      std::vector<int> const &leftBegins, std::vector<int> const &leftEnds, Compare comp);
+        template <typename Compare>
+        static int coRank(T *const left, int const leftSize, T *const right, int const rightSize, int const k, Compare comp);
+        template <typename Compare>
+        void mergeSortParallelWith(T *const buffer, int threads, Compare comp);
+
+        // For bubbleSort, selectionSort et quickSort (pivot le dernier element)
+        template <typename Compare>
+        static void bubbleSortRange(T *const array, int const size, Compare comp);
+        template <typename Compare>
+        static void selectionSortRange(T *const array, int const size, Compare comp);
+        template <typename Compare>
+        static void quickSortLastPivot(T *const array, int const size, int const maxLevels, Compare comp);
+
+        // cas de base des tris divide and conquer: réseau de tri SIMD pour les types de 32 bits (voir SimdSort.hpp), insertion sort sinon
+        template <typename Compare>
+        static void insertionSortRange(T *const array, int const start, int const end, Compare comp);
+        template <typename Compare>
+        static void smallSortRange(T *const array, int const start, int const end, Compare comp);
+        template <typename Compare>
+        static int smallRangeCutoff() { return SimdSort<T, Compare>::enabled ? SIMD_SORT_BLOCK : SMALL_RANGE_CUTOFF; }
 
         // For heapSort
-        void heapifyAscending(int size, int root);
-        void heapifyDescending(int size, int root);
+        template <typename Compare>
+        static void siftDown(T *const heap, int const size, int root, Compare comp);
+        template <typename Compare>
+        static void heapSortRange(T *const array, int const start, int const end, Compare comp);
+
+        // For introSort
+        template <typename Compare>
+        static void introSortLoop(T *const array, int const size, Compare comp);
+        template <typename Compare>
+        static int medianOfThree(T *const array, int const a, int const b, int const c, Compare comp);
+        template <typename Compare>
+        static int choosePivot(T *const array, int const start, int const end, Compare comp);
+        template <typename Compare>
+        static int partitionAroundPivot(T *const array, int const start, int const end, Compare comp);
+        template <typename Compare>
+        static int partitionAroundPivot(T *const array, int const start, int const end, int const pivotIndex, Compare comp);
+
+        // For nthElement et percentiles: la partition de introSort, médiane des médianes quand elle dégénère
+        template <typename Compare>
+        static void selectLoop(T *const array, int const size, int const k, Compare comp);
+        template <typename Compare>
+        static void multiSelect(T *const array, int const start, int const end, int const *const ranks, int const count, int const depthLeft, Compare comp);
+        template <typename Compare>
+        static int medianOfMedians(T *const array, int const start, int const end, Compare comp);
+        int percentileRank(double const p) const;
+
+        // For quickSort3Way
+        template <typename Compare>
+        static void quickSort3WayLoop(T *const array, int const size, Compare comp);
+        template <typename Compare>
+        static void partitionThreeWay(T *const array, int const start, int const end, int &lessEnd, int &greaterStart, Compare comp);
+
+        // For blockQuickSort
+        template <typename Compare>
+        static void blockQuickSortLoop(T *const array, int const size, Compare comp);
+        template <typename Compare>
+        static int blockPartition(T *const array, int const start, int const end, Compare comp);
+
+        // For radixSort, radixSortParallel, countingSort et stringSort: choisi à la compilation selon que T a une clé radix (ou est une chaîne) ou pas
+        void radixSortDispatch(bool ascending, std::true_type);
+        void radixSortDispatch(bool ascending, std::false_type);
+        void radixSortParallelDispatch(bool ascending, int threads, std::true_type);
+        void radixSortParallelDispatch(bool ascending, int threads, std::false_type);
+        void countingSortDispatch(bool ascending, std::true_type);
+        void countingSortDispatch(bool ascending, std::false_type);
+        void stringSortDispatch(bool ascending, std::true_type);
+        void stringSortDispatch(bool ascending, std::false_type);
+
+        // For argSort et searchBatch: paires (clé, index) triées par radixSort si T a une clé radix, sinon les index triés par mergeSort
+        template <typename Index>
+        static void argSortRange(T const *const array, int const size, Index *const permutation, bool ascending, std::true_type);
+        template <typename Index>
+        static void argSortRange(T const *const array, int const size, Index *const permutation, bool ascending, std::false_type);
+
+        // For mergeFrom: les shards lus dans l'ordre voulu (une copie retournée pour ceux triés dans l'autre ordre)
+        static bool shardRuns(std::vector<MyCollection<T>> const &shards, bool ascending, std::vector<SortedRun<T>> &runs, std::vector<std::vector<T>> &reversed);
+        void mergeFromWith(std::vector<MyCollection<T>> const &shards, bool ascending, int threads);
 
     public:
-        MyCollection(std::vector<T> &collection); // checks if collection is sorted
-        MyCollection(MyCollection &other);
+        MyCollection(std::vector<T> &collection, int threads = 1); // checks if collection is sorted, threads = 0: autant que de coeurs
+        MyCollection(MyCollection const &other);
         // sorting algos: ascending if true, descending if false
         void bubbleSort(bool ascending = true);
         void selectionSort(bool ascending = true);
@@ -39,21 +167,67 @@ namespace mycollections
 
         // algorithms with divide and conquer approach
         void mergeSortRecursive(bool ascending = true);
-        // void mergeSort(bool ascending = true);
+        void mergeSortRecursive(bool ascending, std::vector<T> &buffer); // buffer fourni par l'appelant
+        void mergeSortBottomUp(bool ascending = true);                   // sans récursion
+        void mergeSortBottomUp(bool ascending, std::vector<T> &buffer);
+        void mergeSortParallel(bool ascending = true, int threads = 0); // threads = 0: autant que de coeurs
+        void timSort(bool ascending = true);                            // adaptatif, proche de O(n) sur une collection presque triée
         void quickSort(bool ascending = true, int maxLevels = 64); // par défaut support 2⁶⁴ niveaux
         void heapSort(bool ascending = true);
-
-        // searching algos (comming in V0.5)
-        int binarySearch(T value); // only if sorted
-        int normalSearch(T value);
+        void introSort(bool ascending = true);     // quickSort qui garantit O(n*logn)
+        void quickSort3Way(bool ascending = true); // pour les collections avec beaucoup de doublons
+        void blockQuickSort(bool ascending = true); // partition sans branchement (BlockQuicksort)
+        void sampleSort(bool ascending = true, int threads = 0); // parallèle et en place, threads = 0: autant que de coeurs
+        void radixSort(bool ascending = true);                  // types entiers, sinon mergeSortRecursive
+        void radixSortParallel(bool ascending = true, int threads = 0); // types entiers, sinon mergeSortParallel
+        void countingSort(bool ascending = true);                       // si max - min est petit devant la taille, sinon radixSort
+        void stringSort(bool ascending = true);                         // std::string, sinon blockQuickSort
+
+        // choisit le tri selon sizeof(T), le type, la taille et l'ordre de la collection, avec les seuils calibrés sur la machine (voir SortConfig.hpp)
+        void sort(bool ascending = true);
+
+        // tri avec n'importe quel comparateur (sort<Greater>(), sort(myCompare)) ou sur une clé (sortBy(&Record::age))
+        // (jamais un nombre: sort(1) ou sort(flag) avec un int appelle le sort(ascending) du dessus)
+        template <typename Compare = std::less<T>, typename = typename std::enable_if<!std::is_arithmetic<Compare>::value>::type>
+        void sort(Compare comp = Compare());
+        template <typename Projection, typename Compare = Less>
+        void sortBy(Projection projection, Compare comp = Compare());
+
+        // argsort: la permutation qui trierait la collection, sans déplacer ses elements (gather l'applique à d'autres colonnes)
+        template <typename Index = uint32_t>
+        std::vector<Index> argSort(bool ascending = true) const;
+
+        // tri des clés (la collection) avec une colonne de payloads à part (structure of arrays), stable
+        template <typename Payload>
+        void sortWithPayload(std::vector<Payload> &payloads, bool ascending = true);
+
+        // merge de collections déja triées (des shards), dans un ordre ou dans l'autre: remplace le contenu de cette collection
+        void mergeFrom(std::vector<MyCollection<T>> const &shards, bool ascending = true);
+        void mergeFromParallel(std::vector<MyCollection<T>> const &shards, bool ascending = true, int threads = 0); // threads = 0: autant que de coeurs
+
+        // selection sans tri complet, O(n): la collection est seulement partitionnée autour des rangs demandés (plus triée ensuite, sauf si elle l'était)
+        T nthElement(int k, bool ascending = true);                   // l'element au rang k dans l'ordre voulu (0: le plus petit si ascending)
+        T percentile(double p);                                       // p dans [0, 100], rang le plus proche: le plus petit element >= à p% des elements
+        std::vector<T> percentiles(std::vector<double> const &ps);    // plusieurs percentiles avec une seule suite de partitions
+
+        // searching algos: binarySearch et les bornes seulement si la collection est triée, dans un ordre ou dans l'autre (sinon -1)
+        int binarySearch(T const &value) const;                // index du premier element égal à value, -1 si absent
+        int normalSearch(T const &value) const;                // parcours linéaire (SIMD pour u32, int32 et float), triée ou pas
+        void searchBatch(T const *keys, std::size_t n, int64_t *out, bool sortKeys = false) const; // out[i] = binarySearch(keys[i]), recherches menées de front
+        int lowerBound(T const &value) const;                  // premier index dont l'element ne passe pas avant value
+        int upperBound(T const &value) const;                  // premier index dont l'element passe aprés value
+        std::pair<int, int> equalRange(T const &value) const; // [lowerBound, upperBound): les elements égaux à value
+        EytzingerIndex<T> buildIndex() const;                 // index de recherche cache friendly de la collection triée (voir EytzingerIndex.hpp)
+        LearnedIndex<T> buildLearnedIndex(int leaves = 0) const; // index appris pour des clés numériques presque uniformes (voir LearnedIndex.hpp)
 
         // getters
         bool isSorted() const { return this->sorted; }
         bool isAscending() const { return this->ascending; }
         std::vector<T> getCollection() const { return this->collection; }
+        Presortedness getPresortedness() const { return this->presortedness; } // runs et inversions au constructeur ou au dernier setCollection
 
         // setters
-        void setCollection(std::vector<T> &collection) { this->collection = collection; }
+        void setCollection(std::vector<T> &collection, int threads = 1); // refait l'analyse de la collection
 
         // useful
         void shamble(); // to be called after sorting to resort the elements in a random way
@@ -83,40 +257,51 @@ namespace mycollections
      */
 
     /**
-     * Dans les fonctions qui suivent la condition du ascending enveloppe toute la boucle de trie pour avoir le minimum possible de branchements (de ifs)
+     * Dans les fonctions qui suivent le ascending choisit une seule fois le comparateur (std::less ou std::greater) passé en paramètre template
+     * aux fonctions de tri: il est inliné à la compilation, la boucle de tri n'est écrite qu'une fois et ne contient aucun if sur l'ordre.
+     * Les boucles travaillent sur des pointeurs (&collection[0]) et non pas avec .at(): pas de vérification des bornes à chaque accés.
+     */
+    template <typename T>
+    MyCollection<T>::MyCollection(std::vector<T> &collection, int threads) : collection(collection)
+    {
+        checkOrder(threads, std::integral_constant<bool, IsOrdered<T>::value>());
+    }
+
+    /**
+     * Un seul passage sur la collection (voir Presortedness.hpp) pour savoir si elle est déja triée, dans quel ordre,
+     * combien elle a de runs et à quel point elle est en désordre. Une collection vide, d'un element ou constante est triée (ascending).
+     * Seulement si T a les opérateurs < et >, sinon la collection ne peut être triée qu'avec sort(comp) ou sortBy et n'est pas considérée triée.
      */
     template <typename T>
-    MyCollection<T>::MyCollection(std::vector<T> &collection) : collection(collection)
+    void MyCollection<T>::checkOrder(int threads, std::true_type)
+    {
+        this->presortedness = analyzePresortedness(this->collection.empty() ? nullptr : &this->collection[0], this->collection.size(), threads);
+        this->sorted = this->presortedness.ascending || this->presortedness.descending;
+        this->ascending = !this->presortedness.descending || this->presortedness.ascending;
+        this->presortednessCurrent = true;
+    }
+
+    template <typename T>
+    void MyCollection<T>::checkOrder(int, std::false_type)
     {
-        // need to check if T has operators < and > defined
+        this->presortedness = Presortedness();
+        this->presortednessCurrent = false;
         this->sorted = false;
-        // check if already sorted ascending or descending wise
-        bool isAscending = true, isDescending = true;
-        for (int i = 0; i < collection.size() - 1; i++)
-        {
-            if (collection[i] > collection[i + 1] && isAscending)
-            {
-                isAscending = false;
-            }
-            else if (collection[i] < collection[i + 1] && isDescending)
-            {
-                isDescending = false;
-            }
-            else if (!isDescending && !isAscending)
-                return;
-        }
+        this->ascending = true;
+    }
 
-        this->sorted = true;
-        if (isAscending && !isDescending)
-            this->ascending = true;
-        else if (isDescending && !isAscending)
-            this->ascending = false;
-        else
-            std::cerr << "Something wrong happened, a collection cannot be sorted ascending wise and descending wise at the same time!!!" << std::endl;
+    /**
+     * Remplace la collection et refait l'analyse: les attributs sorted et ascending sont ceux des nouvelles données.
+     */
+    template <typename T>
+    void MyCollection<T>::setCollection(std::vector<T> &collection, int threads)
+    {
+        this->collection = collection;
+        checkOrder(threads, std::integral_constant<bool, IsOrdered<T>::value>());
     }
 
     template <typename T>
-    MyCollection<T>::MyCollection(MyCollection &other) : collection(other.collection), sorted(other.sorted), ascending(other.ascending)
+    MyCollection<T>::MyCollection(MyCollection const &other) : sorted(other.sorted), ascending(other.ascending), collection(other.collection), presortedness(other.presortedness), presortednessCurrent(other.presortednessCurrent)
     {
         // std::cout<<"Other collection is at " << &other.collection[0] << " while this' collection is at: " << &this->collection[0] << std::endl;
     }
@@ -160,16 +345,10 @@ namespace mycollections
         engine generator(seed);
         std::uniform_int_distribution<u32> distribute(0, this->collection.size() - 1);
 
-        T tmp;
-        u32 r;
-
         for (int i = 0; i < this->collection.size(); i++)
-        {
-            r = distribute(generator);
-            tmp = this->collection.at(i);
-            this->collection.at(i) = this->collection.at(r);
-            this->collection.at(r) = tmp;
-        }
+            std::swap(this->collection[i], this->collection[distribute(generator)]);
+        this->sorted = this->collection.size() < 2; // sinon le prochain tri dans le même ordre croirait la collection toujours triée
+        this->presortednessCurrent = false;
 
         // std::cout << "After: "<< *this << std::endl;
     }
@@ -185,41 +364,39 @@ namespace mycollections
             std::cout << "Collection is already sorted!" << std::endl;
             return;
         }
-        this->ascending = ascending;
-        // int tmp;
-        /*
-         * the last i elements are always sorted
-         */
-        if (ascending)
+
+        if (this->collection.size() > 1)
         {
-            for (int i = 0; i < this->collection.size(); i++)
-            {
-                this->sorted = true;
-                for (int j = 0; j < this->collection.size() - i - 1; j++)
-                {
-                    if (this->collection.at(j) > this->collection.at(j + 1))
-                    {
-                        swap(this->collection.at(j), this->collection.at(j + 1));
-                        this->sorted = false;
-                    }
-                }
-            }
-            return;
+            if (ascending)
+                bubbleSortRange(&this->collection[0], this->collection.size(), std::less<T>());
+            else
+                bubbleSortRange(&this->collection[0], this->collection.size(), std::greater<T>());
         }
-        else
+        this->sorted = true;
+        this->ascending = ascending;
+    }
+
+    /*
+     * the last i elements are always sorted
+     * if a round does not swap anything the collection is sorted and we can stop
+     */
+    template <typename T>
+    template <typename Compare>
+    void MyCollection<T>::bubbleSortRange(T *const array, int const size, Compare comp)
+    {
+        for (int i = 0; i < size; i++)
         {
-            for (int i = 0; i < this->collection.size(); i++)
+            bool swapped = false;
+            for (int j = 0; j < size - i - 1; j++)
             {
-                this->sorted = true;
-                for (int j = 0; j < this->collection.size() - i - 1; j++)
+                if (comp(array[j + 1], array[j]))
                 {
-                    if (this->collection.at(j) < this->collection.at(j + 1))
-                    {
-                        swap(this->collection.at(j), this->collection.at(j + 1));
-                        this->sorted = false;
-                    }
+                    std::swap(array[j], array[j + 1]);
+                    swapped = true;
                 }
             }
+            if (!swapped)
+                return;
         }
     }
 
@@ -237,56 +414,43 @@ namespace mycollections
             return;
         }
 
-        this->ascending = ascending;
-        int min, max; // stores the indexes of the max and min
-        int s, e;     // stores the start and end indexes of this round
-        if (ascending)
+        if (this->collection.size() > 1)
         {
-
-            for (s = 0; s < (this->collection.size() / 2); s++) // if even then size/2 rounds, if odd size-1/2 rounds are enough (only one element in last round)
-            {
-                e = this->collection.size() - 1 - s;
-                min = s;
-                max = s;
-                for (int j = s; j <= e; j++)
-                {
-                    if (this->collection.at(j) > this->collection.at(max)) // gets the max's index
-                        max = j;
-                    if (this->collection.at(j) < this->collection.at(min)) // gets the min's index
-                        min = j;
-                }
-                // ascending so max to the end, and min to the start
-                // std::cerr << "s = " << s << " ,e = "<<e<<" , max = "<< this->collection.at(max) << " ,min = " << this->collection.at(min) <<" collection = "<< *this << std::endl;
-                swap(this->collection.at(max), this->collection.at(e)); // if min is at e, i will lose my min
-                if (min == e)
-                    min = s; // if min was at e, know it is at index max as a consquence of previous swap
-                swap(this->collection.at(min), this->collection.at(s));
-            }
-            this->sorted = true;
-            return;
+            if (ascending)
+                selectionSortRange(&this->collection[0], this->collection.size(), std::less<T>());
+            else
+                selectionSortRange(&this->collection[0], this->collection.size(), std::greater<T>());
         }
-        else
+        this->sorted = true;
+        this->ascending = ascending;
+    }
+
+    /*
+     * 'first' est l'index de l'element qui passe avant tous les autres du round (le min en ascending, le max en descending)
+     * et 'last' celui qui passe aprés tous les autres.
+     */
+    template <typename T>
+    template <typename Compare>
+    void MyCollection<T>::selectionSortRange(T *const array, int const size, Compare comp)
+    {
+        int first, last; // stores the indexes of the first and last elements of this round
+        int s, e;        // stores the start and end indexes of this round
+        for (s = 0; s < size / 2; s++) // if even then size/2 rounds, if odd size-1/2 rounds are enough (only one element in last round)
         {
-            for (s = 0; s < (this->collection.size() / 2); s++) // if even then size/2 rounds, if odd size-1/2 rounds are enough (only one element in last round)
+            e = size - 1 - s;
+            first = s;
+            last = s;
+            for (int j = s; j <= e; j++)
             {
-                e = this->collection.size() - 1 - s;
-                min = s;
-                max = s;
-                for (int j = s; j <= e; j++)
-                {
-                    if (this->collection.at(j) > this->collection.at(max)) // gets the max's index
-                        max = j;
-                    if (this->collection.at(j) < this->collection.at(min)) // gets the min's index
-                        min = j;
-                }
-                // descending so max at s and min at e
-                // std::cerr << "s = " << s << " ,e = "<<e<<" , max = "<< this->collection.at(max) << "("<<max<<") ,min = " << this->collection.at(min) << "("<<min<<") collection = "<< *this << std::endl;
-                swap(this->collection.at(max), this->collection.at(s)); // if min is at s: i will lose my min
-                if (min == s)
-                    min = max; // if min was at s know it is at max as a consequence of the previous swap
-                swap(this->collection.at(min), this->collection.at(e));
+                if (comp(array[last], array[j]))
+                    last = j;
+                if (comp(array[j], array[first]))
+                    first = j;
             }
-            this->sorted = true;
+            std::swap(array[last], array[e]); // if first is at e, i will lose my first
+            if (first == e)
+                first = last; // if first was at e, now it is at index last as a consequence of previous swap
+            std::swap(array[first], array[s]);
         }
     }
 
@@ -294,7 +458,7 @@ namespace mycollections
      * Ressemble un peu à la selection sort. Ici on essaie de trouver la place d'un element
      * au lieu de trouver le min ou le max pour le placer au debut ou la fin de la liste
      * Ici on essaie d'avancer tout en triant la table, du coup on aura une partie pseudo-trié
-     * et une autre partie non triée.
+     * et une autre partie non triée (voir insertionSortRange).
      *
      * Seul avantage: si liste déja triée complexité O(N), mais ce cas est en O(1) dans toutes
      * les fonctions de cette classe gràce aux attributs sorted et ascending
@@ -307,51 +471,39 @@ namespace mycollections
             std::cout << "Collection is already sorted!" << std::endl;
             return;
         }
-        this->ascending = ascending;
 
-        signed int j;
-        if (ascending)
-        {
-            for (int i = 0; i < this->collection.size() - 1; i++) // to size - 1 because of j+1
-            {
-                j = i;
-
-                // on essaie de trouver la bonne place pour l'element j dans la partie triée
-                // on check d'abord la valeur de j pour ne pas avoir d'erreur d'acces pour le .at(j)
-                while (j >= 0 && this->collection.at(j) > this->collection.at(j + 1))
-                {
-                    swap(this->collection.at(j), this->collection.at(j + 1)); // l'element à j n'est plus le même
-                    j--;
-                }
-            }
-            this->sorted = true;
-            return;
-        }
-        else
+        if (this->collection.size() > 1)
         {
-            for (int i = 0; i < this->collection.size() - 1; i++) // to size - 1 because of j+1
-            {
-                j = i;
-
-                // on essaie de trouver la bonne place pour l'element j
-                while (j >= 0 && this->collection.at(j) < this->collection.at(j + 1))
-                {
-                    swap(this->collection.at(j), this->collection.at(j + 1)); // l'element à j n'est plus le même
-                    j--;
-                }
-            }
-            this->sorted = true;
+            if (ascending)
+                insertionSortRange(&this->collection[0], 0, this->collection.size(), std::less<T>());
+            else
+                insertionSortRange(&this->collection[0], 0, this->collection.size(), std::greater<T>());
         }
+        this->sorted = true;
+        this->ascending = ascending;
     }
 
     /**
      * 1- Split en deux sub arrays
-     * 2- Une fois sub array d'un element ou zero arret
-     * 3- Merge et sort les elements
-     * Dans le merge il faut faire attention à bien verifier le cas des égalité vu que là en copie des valeurs et non les swapper (autrement dit on peut les perdre)
+     * 2- Une fois sub array de moins de SMALL_RANGE_CUTOFF elements on fait un insertion sort (SIMD_SORT_BLOCK elements et un réseau de tri
+     *    dans les registres pour u32, int32 et float, voir SimdSort.hpp)
+     * 3- Merge et sort les elements (merge bitonique dans les registres pour ces mêmes types)
+     * Un seul buffer de la taille de la collection est alloué au début, chaque niveau de récursion
+     * merge de l'un vers l'autre (ping-pong) au lieu de copier les deux moitiés dans des new T[] temporaires.
      */
     template <typename T>
     void MyCollection<T>::mergeSortRecursive(bool ascending)
+    {
+        std::vector<T> buffer;
+        mergeSortRecursive(ascending, buffer);
+    }
+
+    /**
+     * @param buffer fourni par l'appelant, il est redimensionné si besoin et peut être réutilisé d'un tri à l'autre
+     * sans nouvelle allocation.
+     */
+    template <typename T>
+    void MyCollection<T>::mergeSortRecursive(bool ascending, std::vector<T> &buffer)
     {
         if (this->sorted && !(ascending ^ this->ascending)) // if already sorted in wanted order: !(a^b) means a==b.
         {
@@ -359,212 +511,363 @@ namespace mycollections
             return;
         }
 
-        // r est le end enfaite
-        int r = this->collection.size() - 1;
-        if (r <= 0) // un seul element ou vide
+        int size = this->collection.size();
+        if (size > 1)
+        {
+            // le ping-pong suppose que les deux tableaux contiennent les mêmes valeurs au départ
+            buffer.assign(this->collection.begin(), this->collection.end());
+            if (ascending)
+                mergeSplitPingPong(&buffer[0], &this->collection[0], 0, size, std::less<T>());
+            else
+                mergeSplitPingPong(&buffer[0], &this->collection[0], 0, size, std::greater<T>());
+        }
+        this->sorted = true;
+        this->ascending = ascending;
+    }
+
+    /**
+     * Version sans récursion: on trie d'abord des blocs de SMALL_RANGE_CUTOFF elements par insertion (ou SIMD_SORT_BLOCK par réseau de tri),
+     * puis on merge des runs de taille 16, 32, 64... en alternant entre la collection et le buffer.
+     */
+    template <typename T>
+    void MyCollection<T>::mergeSortBottomUp(bool ascending)
+    {
+        std::vector<T> buffer;
+        mergeSortBottomUp(ascending, buffer);
+    }
+
+    template <typename T>
+    void MyCollection<T>::mergeSortBottomUp(bool ascending, std::vector<T> &buffer)
+    {
+        if (this->sorted && !(ascending ^ this->ascending)) // if already sorted in wanted order: !(a^b) means a==b.
+        {
+            std::cout << "Collection is already sorted!" << std::endl;
             return;
-        int m = r / 2;
+        }
 
-        // std::cout<<"Calling true recursive"<<std::endl;
-        if (ascending)
-            trueMergeSortRecursiveAscending(&this->collection[0], m, r);
-        else
-            trueMergeSortRecursiveDescending(&this->collection[0], m, r);
+        int size = this->collection.size();
+        if (size > 1)
+        {
+            if (buffer.size() < this->collection.size()) // ici le contenu du buffer n'a pas d'importance
+                buffer.resize(this->collection.size());
+            if (ascending)
+                mergeBottomUp(&this->collection[0], &buffer[0], size, std::less<T>());
+            else
+                mergeBottomUp(&this->collection[0], &buffer[0], size, std::greater<T>());
+        }
         this->sorted = true;
         this->ascending = ascending;
     }
 
+    /**
+     * Trie [start, end) de source vers destination.
+     * A l'entrée source et destination contiennent les mêmes valeurs sur [start, end), du coup les deux moitiés
+     * sont triées vers source (en se servant de destination comme brouillon) puis mergées dans destination.
+     */
     template <typename T>
-    void MyCollection<T>::trueMergeSortRecursiveAscending(T *const collection, int const midpoint, int const end)
+    template <typename Compare>
+    void MyCollection<T>::mergeSplitPingPong(T *const source, T *const destination, int const start, int const end, Compare comp)
     {
-        // std::cout << "Initiating method with midpoint: "<<midpoint<<", end: "<<end<<std::endl;
-        //  recursion base
-        if (end <= 0)
-        { // if one element or empty
-            // std::cout<<" Base condition reached "<< std::endl;
+        if (end - start <= smallRangeCutoff<Compare>())
+        {
+            smallSortRange(destination, start, end, comp);
             return;
         }
+        int midpoint = start + (end - start) / 2;
+        // recursion: going down, les rôles des deux tableaux sont inversés
+        mergeSplitPingPong(destination, source, start, midpoint, comp);
+        mergeSplitPingPong(destination, source, midpoint, end, comp);
+        // recursion: going up
+        mergeRuns(source, destination, start, midpoint, end, comp);
+    }
 
-        // Enough elements are present
-        // creating the temp arrays
-        int leftSize = midpoint + 1;
-        int rightSize = end - midpoint;
-
-        T *const leftArray = new T[leftSize]; // const after * then pointer is const
-        T *const rightArray = new T[rightSize];
+    template <typename T>
+    template <typename Compare>
+    void MyCollection<T>::mergeBottomUp(T *const collection, T *const buffer, int const size, Compare comp)
+    {
+        int const cutoff = smallRangeCutoff<Compare>();
+        for (int s = 0; s < size; s += cutoff)
+            smallSortRange(collection, s, std::min(s + cutoff, size), comp);
 
-        // [0] to [midpoint]
-        for (int i = 0; i < leftSize; i++)
+        T *source = collection;
+        T *destination = buffer;
+        for (int width = cutoff; width < size; width *= 2)
         {
-            leftArray[i] = collection[i];
+            for (int start = 0; start < size; start += 2 * width)
+            {
+                int midpoint = std::min(start + width, size);
+                int end = std::min(start + 2 * width, size);
+                mergeRuns(source, destination, start, midpoint, end, comp); // si midpoint == end c'est juste une copie
+            }
+            std::swap(source, destination);
         }
 
-        // [midpoint + 1] to [end]
-        for (int i = 0; i < rightSize; i++)
+        // aprés un nombre impair de passes le resultat est dans le buffer
+        if (source != collection)
+            std::move(source, source + size, collection);
+    }
+
+    /**
+     * 1- La collection est coupée en autant de runs que de threads, chaque thread trie le sien avec le merge sort ping-pong
+     * 2- Les runs sont mergés deux à deux niveau par niveau. A chaque niveau la sortie [0, size) est coupée en segments égaux,
+     *    un par thread, et le co-rank donne pour chaque borne de segment combien d'elements viennent du run de gauche et de droite.
+     *    Du coup même le dernier merge (deux runs de size/2) est fait par tous les threads.
+     * Le merge reste stable, le resultat est le même que mergeSortRecursive.
+     * @param threads 0 par défaut, i.e. autant de threads que de coeurs
+     */
+    template <typename T>
+    void MyCollection<T>::mergeSortParallel(bool ascending, int threads)
+    {
+        if (this->sorted && !(ascending ^ this->ascending)) // if already sorted in wanted order: !(a^b) means a==b.
         {
-            rightArray[i] = collection[i + midpoint + 1];
+            std::cout << "Collection is already sorted!" << std::endl;
+            return;
         }
 
-        // std::cout << " Recursion: left:"<< leftSize << ", right:" << rightSize << std::endl;
-        //  recursion: going down
-        trueMergeSortRecursiveAscending(leftArray, (leftSize - 1) / 2, leftSize - 1);
-        trueMergeSortRecursiveAscending(rightArray, (rightSize - 1) / 2, rightSize - 1);
-
-        // recursion: going up
-        // we need to merge and sort
-        int leftIndex = 0;
-        int rightIndex = 0;
-        int mergedIndex = 0;
-        int mergedSize = end + 1; // variable can be removed
+        if (this->collection.size() > 1)
+        {
+            std::vector<T> buffer(this->collection);
+            threads = effectiveThreads(threads, this->collection.size());
+            if (ascending)
+                mergeSortParallelWith(&buffer[0], threads, std::less<T>());
+            else
+                mergeSortParallelWith(&buffer[0], threads, std::greater<T>());
+        }
+        this->sorted = true;
+        this->ascending = ascending;
+    }
 
-        /**
-         * Les indexes des subArrays s'increment de facon independante
-         * Si l'element d'un subarray est ajouté au mergedArray (collection) son index s'incremente
-         * On ajoute à chaque fois l'element le plus petit (grand) entre les premiers elements de chaque subarray
-         * Il suffit de comparer les premiers elements de chaque subarray parce qu'on est sur qu'ils sont triés
-         */
+    template <typename T>
+    template <typename Compare>
+    void MyCollection<T>::mergeSortParallelWith(T *const buffer, int threads, Compare comp)
+    {
+        int size = this->collection.size();
+        T *const data = &this->collection[0];
+
+        // bounds[r] à bounds[r + 1] est le run r
+        std::vector<int> bounds(threads + 1);
+        for (int t = 0; t <= threads; t++)
+            bounds[t] = (long long)size * t / threads;
+
+        // les feuilles: buffer et collection contiennent les mêmes valeurs, le resultat va dans la collection
+        parallelFor(threads, [&](int t)
+                    { mergeSplitPingPong(buffer, data, bounds[t], bounds[t + 1], comp); });
+
+        T *source = data;
+        T *destination = buffer;
+        std::vector<std::vector<int>> leftTaken(threads + 1);
+        while (bounds.size() > 2)
+        {
+            // toutes les découpes du niveau avant qu'un thread ne déplace quoi que ce soit: les recherches de coRank lisent
+            // des elements que les segments voisins déplacent (pour un std::string, une chaîne vidée par son move)
+            parallelFor(threads, [&](int t)
+                        {
+                            levelCoRanks(source, bounds, (long long)size * t / threads, leftTaken[t], comp);
+                            if (t == threads - 1)
+                                levelCoRanks(source, bounds, size, leftTaken[threads], comp); });
+            parallelFor(threads, [&](int t)
+                        { mergeLevelSegment(source, destination, bounds, (long long)size * t / threads, (long long)size * (t + 1) / threads,
+                                            leftTaken[t], leftTaken[t + 1], comp); });
+
+            std::vector<int> next;
+            for (std::size_t r = 0; r + 1 < bounds.size(); r += 2)
+                next.push_back(bounds[r]);
+            next.push_back(size);
+            bounds.swap(next);
+            std::swap(source, destination);
+        }
 
-        // std::cout << "Merging" << std::endl;
-        // std::cout << " Left Array: "<<std::endl;
-        // print_array(leftArray, leftSize);
-        // std::cout << " Right Array: "<<std::endl;
-        // print_array(rightArray, rightSize);
+        if (source != data)
+            parallelFor(threads, [&](int t)
+                        {
+                            int s = (long long)size * t / threads;
+                            int e = (long long)size * (t + 1) / threads;
+                            std::move(source + s, source + e, data + s); });
+    }
 
-        for (int i = 0; i < mergedSize; i++)
-        { // ascending order
-            if (leftIndex >= leftSize || rightIndex >= rightSize)
-            {
-                mergedIndex = i;
-                break; // break if one subarray has no more elements
-            }
-            if (leftArray[leftIndex] <= rightArray[rightIndex])
-            {
-                collection[i] = leftArray[leftIndex];
-                leftIndex++;
-            }
-            else // if (rightArray[rightIndex] < leftArray[leftIndex])
-            {
-                collection[i] = rightArray[rightIndex];
-                rightIndex++;
-            }
+    /**
+     * Pour chaque paire de runs du niveau: le nombre d'elements pris dans le run de gauche par les out premiers elements de la sortie
+     * (out borné à la paire). Ne fait que lire source.
+     */
+    template <typename T>
+    template <typename Compare>
+    void MyCollection<T>::levelCoRanks(T *const source, std::vector<int> const &bounds, int const out, std::vector<int> &leftTaken, Compare comp)
+    {
+        int last = bounds.size() - 1;
+        leftTaken.assign((last + 1) / 2, 0);
+        for (int p = 0; 2 * p < last; p++)
+        {
+            int start = bounds[2 * p];
+            int midpoint = bounds[std::min(2 * p + 1, last)];
+            int end = bounds[std::min(2 * p + 2, last)];
+            int k = std::min(std::max(out, start), end) - start;
+            leftTaken[p] = coRank(source + start, midpoint - start, source + midpoint, end - midpoint, k, comp);
         }
+    }
 
-        // std::cout << " Adding remaining elements: left:"<< leftSize << "(" << leftIndex << "), right:" << rightSize << "(" << rightIndex << ")" << std::endl;
-        //  Ajout des elements restants du subarray restant
-        if (leftIndex >= leftSize) // du coup il en reste à droite
+    /**
+     * Produit destination[outBegin, outEnd) pour un niveau de merge ou les runs (bounds) sont mergés deux à deux.
+     * Un run sans voisin (nombre impair de runs) est juste copié.
+     */
+    template <typename T>
+    template <typename Compare>
+    void MyCollection<T>::mergeLevelSegment(T *const source, T *const destination, std::vector<int> const &bounds, int const outBegin, int const outEnd,
+                                            std::vector<int> const &leftBegins, std::vector<int> const &leftEnds, Compare comp)
+    {
+        int last = bounds.size() - 1;
+        for (int p = 0; 2 * p < last; p++)
         {
-            for (int i = mergedIndex; i < mergedSize; i++)
-            {
-                collection[i] = rightArray[rightIndex];
-                rightIndex++;
-            }
-        }
-        else if (rightIndex >= rightSize)
-        { // il en reste à gauche
-            for (int i = mergedIndex; i < mergedSize; i++)
+            int start = bounds[2 * p];
+            int midpoint = bounds[std::min(2 * p + 1, last)];
+            int end = bounds[std::min(2 * p + 2, last)];
+            int segBegin = std::max(start, outBegin);
+            int segEnd = std::min(end, outEnd);
+            if (segBegin >= segEnd)
+                continue;
+
+            // nombre d'elements pris à gauche avant segBegin et avant segEnd (calculés par levelCoRanks)
+            int leftBegin = leftBegins[p];
+            int leftEnd = leftEnds[p];
+            int leftIndex = start + leftBegin;
+            int rightIndex = midpoint + (segBegin - start - leftBegin);
+            int leftStop = start + leftEnd;
+            int rightStop = midpoint + (segEnd - start - leftEnd);
+            MYCOLLECTION_CHECK_RANGE(leftIndex, start, leftStop + 1);
+            MYCOLLECTION_CHECK_RANGE(leftStop, leftIndex, midpoint + 1);
+            MYCOLLECTION_CHECK_RANGE(rightIndex, midpoint, rightStop + 1);
+            MYCOLLECTION_CHECK_RANGE(rightStop, rightIndex, end + 1);
+
+            int mergedIndex = segBegin;
+            while (leftIndex < leftStop && rightIndex < rightStop)
             {
-                collection[i] = leftArray[leftIndex];
-                leftIndex++;
+                if (comp(source[rightIndex], source[leftIndex]))
+                    destination[mergedIndex++] = std::move(source[rightIndex++]);
+                else
+                    destination[mergedIndex++] = std::move(source[leftIndex++]);
             }
+            mergedIndex = std::move(source + leftIndex, source + leftStop, destination + mergedIndex) - destination;
+            std::move(source + rightIndex, source + rightStop, destination + mergedIndex);
         }
-
-        // freeing ununsed memory
-        delete[] rightArray;
-        delete[] leftArray;
     }
 
+    /**
+     * Co-rank: combien des k premiers elements du merge stable de left et right viennent de left.
+     * On cherche le plus petit i (j = k - i) tel que right[j - 1] < left[i], i.e. left[i] ne passerait pas avant right[j - 1].
+     */
     template <typename T>
-    void MyCollection<T>::trueMergeSortRecursiveDescending(T *const collection, int const midpoint, int const end)
+    template <typename Compare>
+    int MyCollection<T>::coRank(T *const left, int const leftSize, T *const right, int const rightSize, int const k, Compare comp)
     {
-        // std::cout << "Initiating method with midpoint: "<<midpoint<<", end: "<<end<<std::endl;
-        //  recursion base
-        if (end <= 0)
-        { // if one element or empty
-            // std::cout<<" Base condition reached "<< std::endl;
-            return;
+        int low = std::max(0, k - rightSize);
+        int high = std::min(k, leftSize);
+        while (low < high)
+        {
+            int i = low + (high - low) / 2;
+            int j = k - i;
+            if (j > 0 && !comp(right[j - 1], left[i])) // left[i] <= right[j - 1]: il faut prendre plus à gauche
+                low = i + 1;
+            else
+                high = i;
         }
+        return low;
+    }
 
-        // Enough elements are present
-        // creating the temp arrays
-        int leftSize = midpoint + 1;
-        int rightSize = end - midpoint;
-
-        T *const leftArray = new T[leftSize]; // const after * then pointer is const
-        T *const rightArray = new T[rightSize];
+    /**
+     * Merge source[start, midpoint) et source[midpoint, end) dans destination[start, end).
+     * En cas d'égalité on prend toujours l'element de gauche pour garder un tri stable.
+     */
+    template <typename T>
+    template <typename Compare>
+    void MyCollection<T>::mergeRuns(T *const source, T *const destination, int const start, int const midpoint, int const end, Compare comp)
+    {
+        int leftIndex = start;
+        int rightIndex = midpoint;
+        int mergedIndex = start;
 
-        // [0] to [midpoint]
-        for (int i = 0; i < leftSize; i++)
+        // les deux runs sont déja dans le bon ordre: simple copie
+        if (leftIndex < midpoint && rightIndex < end && !comp(source[rightIndex], source[rightIndex - 1]))
         {
-            leftArray[i] = collection[i];
+            std::move(source + start, source + end, destination + start);
+            return;
         }
 
-        // [midpoint + 1] to [end]
-        for (int i = 0; i < rightSize; i++)
+        // merge bitonique dans les registres pour les types de 32 bits
+        if (SimdSort<T, Compare>::enabled && SimdSort<T, Compare>::merge(source + start, midpoint - start, source + midpoint, end - midpoint, destination + start, comp))
+            return;
+
+        while (leftIndex < midpoint && rightIndex < end)
         {
-            rightArray[i] = collection[i + midpoint + 1];
+            MYCOLLECTION_CHECK_RANGE(mergedIndex, start, end);
+            if (comp(source[rightIndex], source[leftIndex]))
+                destination[mergedIndex++] = std::move(source[rightIndex++]);
+            else
+                destination[mergedIndex++] = std::move(source[leftIndex++]);
         }
+        //  Ajout des elements restants du subarray restant
+        std::move(source + leftIndex, source + midpoint, destination + mergedIndex);
+        std::move(source + rightIndex, source + end, destination + mergedIndex + (midpoint - leftIndex));
+    }
 
-        // std::cout << " Recursion: left:"<< leftSize << ", right:" << rightSize << std::endl;
-        //  recursion: going down
-        trueMergeSortRecursiveDescending(leftArray, (leftSize - 1) / 2, leftSize - 1);
-        trueMergeSortRecursiveDescending(rightArray, (rightSize - 1) / 2, rightSize - 1);
+    /**
+     * Cas de base sur [start, end): au plus SIMD_SORT_BLOCK elements triés dans les registres si T et Compare ont un noyau SIMD,
+     * au plus SMALL_RANGE_CUTOFF elements par insertion sinon (voir smallRangeCutoff).
+     */
+    template <typename T>
+    template <typename Compare>
+    void MyCollection<T>::smallSortRange(T *const array, int const start, int const end, Compare comp)
+    {
+        if (SimdSort<T, Compare>::enabled)
+            SimdSort<T, Compare>::sortBlock(array + start, end - start);
+        else
+            insertionSortRange(array, start, end, comp);
+    }
 
-        // recursion: going up
-        // we need to merge and sort
-        int leftIndex = 0;
-        int rightIndex = 0;
-        int mergedIndex = 0;
-        int mergedSize = end + 1; // variable can be removed
-
-        // std::cout << " Merging\n Left Array: "<<std::endl;
-        // print_array(leftArray, leftSize);
-        // std::cout << " Right Array: "<<std::endl;
-        // print_array(rightArray, rightSize);
-        for (int i = 0; i < mergedSize; i++)
-        { // descending order
-            if (leftIndex >= leftSize || rightIndex >= rightSize)
-            {
-                mergedIndex = i;
-                break; // break if one subarray has no more elements
-            }
-            if (leftArray[leftIndex] >= rightArray[rightIndex])
-            {
-                collection[i] = leftArray[leftIndex];
-                leftIndex++;
-            }
-            else // if (rightArray[rightIndex] > leftArray[leftIndex])
+    /**
+     * Insertion sort sur [start, end) par décalage (pas de swap), utilisé comme cas de base des tris divide and conquer.
+     */
+    template <typename T>
+    template <typename Compare>
+    void MyCollection<T>::insertionSortRange(T *const array, int const start, int const end, Compare comp)
+    {
+        for (int i = start + 1; i < end; i++)
+        {
+            if (!comp(array[i], array[i - 1]))
+                continue;
+            T value = std::move(array[i]);
+            int j = i;
+            do
             {
-                collection[i] = rightArray[rightIndex];
-                rightIndex++;
-            }
+                array[j] = std::move(array[j - 1]);
+                j--;
+            } while (j > start && comp(value, array[j - 1]));
+            array[j] = std::move(value);
         }
-        // std::cout << " Result One is " << std::endl;
-        // print_array(collection, mergedSize);
+    }
 
-        // std::cout << " Adding remaining elements: left:"<< leftSize << "(" << leftIndex << "), right:" << rightSize << "(" << rightIndex << ")" << std::endl;
-        //  Ajout des elements restants du subarray restant
-        if (leftIndex >= leftSize) // du coup il en reste à droite
+    /**
+     * Merge sort naturel et adaptatif à la TimSort (voir TimSort.hpp): les runs déja triés (ou strictement décroissants, retournés)
+     * sont détectés, les trop courts complétés par un insertion sort binaire puis mergés avec galop.
+     * Stable. Sur une collection presque triée (des logs avec une fin un peu dans le désordre) le tri est proche de O(n),
+     * alors que mergeSortRecursive fait toujours tout le travail en O(n*logn).
+     */
+    template <typename T>
+    void MyCollection<T>::timSort(bool ascending)
+    {
+        if (this->sorted && !(ascending ^ this->ascending)) // if already sorted in wanted order: !(a^b) means a==b.
         {
-            for (int i = mergedIndex; i < mergedSize; i++)
-            {
-                collection[i] = rightArray[rightIndex];
-                rightIndex++;
-            }
+            std::cout << "Collection is already sorted!" << std::endl;
+            return;
         }
-        else if (rightIndex >= rightSize)
-        { // il en reste à gauche
-            for (int i = mergedIndex; i < mergedSize; i++)
-            {
-                collection[i] = leftArray[leftIndex];
-                leftIndex++;
-            }
+
+        if (this->collection.size() > 1)
+        {
+            if (ascending)
+                TimSorter<T, std::less<T>>::sort(&this->collection[0], this->collection.size(), std::less<T>());
+            else
+                TimSorter<T, std::greater<T>>::sort(&this->collection[0], this->collection.size(), std::greater<T>());
         }
-        // std::cout << " Result Two is " << std::endl;
-        // print_array(collection, mergedSize);
-        // std::cout << "--------------------\n";
-        //  freeing ununsed memory
-        delete[] rightArray;
-        delete[] leftArray;
+        this->sorted = true;
+        this->ascending = ascending;
     }
 
     /**
@@ -580,6 +883,11 @@ namespace mycollections
     template <typename T>
     void MyCollection<T>::quickSort(bool ascending, int maxLevels)
     {
+        if (this->sorted && !(ascending ^ this->ascending)) // if already sorted in wanted order: !(a^b) means a==b.
+        {
+            std::cout << "Collection is already sorted!" << std::endl;
+            return;
+        }
 
         // Pour eviter un fail relié à la taille limité des tableaux de mémoire des start et end j'ai ajouté
         if (log2(this->collection.size()) > (double)maxLevels)
@@ -587,194 +895,408 @@ namespace mycollections
             myprint::logger::log("Attention! La taille de votre collection pourrait causer une erreur, ceci est due à la taille limitée des tableaux stockant les index de debut et de fin de chaque subarrays (starts[maxLevels] et ends[maxLevels]).\n Veuillez mettre comme deuxième parametre une valeur supérieure au log_2(taille de votre collection).\n", ERROR_LOG);
             return;
         }
+
+        if (this->collection.size() > 1)
+        {
+            if (ascending)
+                quickSortLastPivot(&this->collection[0], this->collection.size(), maxLevels, std::less<T>());
+            else
+                quickSortLastPivot(&this->collection[0], this->collection.size(), maxLevels, std::greater<T>());
+        }
+        this->sorted = true;
+        this->ascending = ascending;
+    }
+
+    template <typename T>
+    template <typename Compare>
+    void MyCollection<T>::quickSortLastPivot(T *const array, int const size, int const maxLevels, Compare comp)
+    {
         /**
          *  A chaque round on consomme un start et end, et on génére au max deux starts et deux ends.
          *  Les tableaux suivent une logique LIFO : ainsi on a besoin que d'une variable supplementaire le STACK POINTER.
          */
         int sp = 0;
-        int start[maxLevels], end[maxLevels];
+        std::vector<int> start(maxLevels), end(maxLevels);
 
         // utilisées par chaque round de façon independante
-        // int pivot;
         int s, start_round, end_round;
 
         // INITIALISATION
         start[sp] = 0;
-        end[sp] = this->collection.size() - 1;
+        end[sp] = size - 1;
         sp++; // sp est à 1 avant d'entrer dans la boucle.
 
-        if (ascending)
+        while (sp > 0) // s'arrete s'il reste plus de subarray à traverser
         {
-            while (sp > 0) // s'arrete s'il reste plus de subarray à traverser
-            {
-                start_round = start[--sp]; // d'abord decremente puis récupére la valeur
-                end_round = end[sp];
-                // le pivot est toujours le dernier element
-                // pivot = end_round;
-                s = start_round - 1; // sans le -1 c'est comme si on supposait que le premier element est plus petit(grand) que le pivot
-                for (int i = start_round; i < end_round; i++)
-                {                                                                // des swaps inutiles peuvent arrivés, on s'arrete juste avant le pivot
-                    if (this->collection.at(i) < this->collection.at(end_round)) // asceding order
-                    {
-                        s++;
-                        swap(this->collection.at(s), this->collection.at(i));
-                    }
-                }
-                // maintenant on met le pivot entre les deux subarray
-                swap(this->collection.at(s + 1), this->collection.at(end_round));
-                /**
-                 * ajouter les deux subarrays generés
-                 * Exemple: sp = 1 à l'entré de la boucle puis devient 0 aprés le start_round = start[--sp]
-                 * Si les deux sont ajouté:
-                 *  1 - start[0] reste comme il était, end[0] est ecrasé avec s et sp = 1
-                 *  2 - start[1] est mis à jour, end[1] = end_round et sp = 2
-                 * Si seulement le 1er est ajouté:
-                 *  1 - start[0] reste comme il était, end[0] est ecrasé avec s et sp = 1
-                 * Si seuelemnt le 2eme est ajouté:
-                 *  2 - start[0] est mis à jour, end[0] = end_round et sp = 1. C'est vrai que le end[0] = end_round est inutile
-                 * */
-                if (start_round < s) // subarray de gauche a plus d'un element
+            start_round = start[--sp]; // d'abord decremente puis récupére la valeur
+            end_round = end[sp];
+            // le pivot est toujours le dernier element
+            s = start_round - 1; // sans le -1 c'est comme si on supposait que le premier element est plus petit(grand) que le pivot
+            for (int i = start_round; i < end_round; i++)
+            { // des swaps inutiles peuvent arrivés, on s'arrete juste avant le pivot
+                if (comp(array[i], array[end_round]))
                 {
-                    // start[sp] ne change pas
-                    end[sp++] = s; // met la valeur puis incremente
-                }
-                if ((s + 2) < end_round) // subarray de droite a plus d'un element
-                {
-                    start[sp] = s + 2;
-                    end[sp++] = end_round;
+                    s++;
+                    std::swap(array[s], array[i]);
                 }
             }
-        }
-        else
-        {
-            while (sp > 0) // s'arrete s'il reste plus de subarray à traverser
+            // maintenant on met le pivot entre les deux subarray
+            std::swap(array[s + 1], array[end_round]);
+            /**
+             * ajouter les deux subarrays generés (s'ils ont plus d'un element): le plus grand d'abord, le plus petit est donc le prochain traité.
+             * Chaque subarray empilé au dessus d'un autre est au plus moitié moins grand que lui: la pile ne dépasse jamais log2(taille) niveaux,
+             * alors qu'en empilant toujours le gauche puis le droit elle pouvait dépasser maxLevels.
+             */
+            int leftStart = start_round, leftEnd = s;     // subarray de gauche
+            int rightStart = s + 2, rightEnd = end_round; // subarray de droite
+            if (leftEnd - leftStart < rightEnd - rightStart)
             {
-                start_round = start[--sp];
-                end_round = end[sp];
-                // le pivot est toujours le dernier element
-                // pivot = end_round;
-                s = start_round - 1; // sans le -1 soit on suppose que le premier element est plus petit(grand) que le pivot
-                for (int i = start_round; i < end_round; i++)
-                {                                                                // des swaps inutiles peuvent arrivés, on s'arrete juste avant le pivot
-                    if (this->collection.at(i) > this->collection.at(end_round)) // desceding order
-                    {
-                        s++;
-                        swap(this->collection.at(s), this->collection.at(i));
-                    }
-                }
-                // maintenant on met le pivot entre les deux subarray
-                swap(this->collection.at(s + 1), this->collection.at(end_round));
-                if (start_round < s) // subarray de gauche a plus d'un element
-                {
-                    // start[sp] ne change pas
-                    end[sp++] = s;
-                }
-                if ((s + 2) < end_round) // subarray de droite a plus d'un element
-                {
-                    start[sp] = s + 2;
-                    end[sp++] = end_round;
-                }
+                std::swap(leftStart, rightStart);
+                std::swap(leftEnd, rightEnd);
+            }
+            if (leftStart < leftEnd) // le plus grand a plus d'un element
+            {
+                MYCOLLECTION_CHECK_RANGE(sp, 0, maxLevels);
+                start[sp] = leftStart;
+                end[sp++] = leftEnd; // met la valeur puis incremente
+            }
+            if (rightStart < rightEnd) // le plus petit a plus d'un element
+            {
+                MYCOLLECTION_CHECK_RANGE(sp, 0, maxLevels);
+                start[sp] = rightStart;
+                end[sp++] = rightEnd;
             }
         }
     }
 
     /**
-     * Heap Sort permet d'avoir une complexité proche du quicksort et mergesort sans utiliser de mémoire en plus.
-     * Comme les subarrays dans merge sort et le stockage des index dans quicksort.
-     *
-     *  La collection va être lu comme un arbre binaire ou un noeud 'i' a ses enfants de droite et de gauche à 'i*2+1' et 'i*2+2' respectivement
-     * Avec cette logique la deuxieme moitié de la collection ne comprendra que des feuilles:
-     *  - Une collection de 11 elements [0..10] aura 6 feuilles: [0..4] sont des noeuds parents et [5..10] seront des feuilles
-
-     * Le heap sort fait en sorte de swaper un parent avec son plus grand (petit) descendants en commencant par le bas (index 4 dans l'exemple).
-     * En suivant cette méthode on aura à la fin d'une iteration le plus grand (petit) element comme racine. Ce dernier et deplacé vers sa place finale
-     * dans la collection. Et en refait la même chose sans le max (min) trouvé dans les iterations precendents jusqu'à avoir une collection triée.
+     * Version "production" du quickSort:
+     *  - pivot médiane de trois (ninther, médiane de trois médianes, pour les grands subarrays)
+     *  - les subarrays de moins de SMALL_RANGE_CUTOFF elements sont finis par un insertion sort (par réseau de tri SIMD jusqu'à SIMD_SORT_BLOCK pour u32, int32 et float)
+     *  - on continue sur le plus petit subarray et on empile le plus grand, la pile ne dépasse donc jamais log2(n) niveaux
+     *  - si un subarray dépasse 2*log2(n) niveaux de partition, il est trié avec le heap sort (pas de O(n²) possible)
      */
+    template <typename T>
+    void MyCollection<T>::introSort(bool ascending)
+    {
+        if (this->sorted && !(ascending ^ this->ascending)) // if already sorted in wanted order: !(a^b) means a==b.
+        {
+            std::cout << "Collection is already sorted!" << std::endl;
+            return;
+        }
+
+        if (this->collection.size() > 1)
+        {
+            if (ascending)
+                introSortLoop(&this->collection[0], this->collection.size(), std::less<T>());
+            else
+                introSortLoop(&this->collection[0], this->collection.size(), std::greater<T>());
+        }
+        this->sorted = true;
+        this->ascending = ascending;
+    }
 
-    /**
-     * Heapify va se charger de faire remonter le max vers la racine.
-     * @param size pour ignorer les derniers elements (déja triées)
-     * @param root nous permet de selectionner qu'une partie de l'arbre vu qu'on doit commencer du bas vers le haut pour trouver le max
-     * A chaque iteration on doit verifier que l'enfant qui recoit la valeur du parent respecte la condition (contient la valeur la plus grande).
-     *  - Par exemple quand le root contient le min cela arrivera souvent.
-     */
     template <typename T>
-    void MyCollection<T>::heapifyAscending(int size, int root)
+    template <typename Compare>
+    void MyCollection<T>::introSortLoop(T *const array, int const size, Compare comp)
     {
-        int left, right;
-        int largest = root;
-        bool rootSwaped;
-        do
+        // 64 niveaux suffisent: on n'empile que le plus grand des deux subarrays, qui est toujours plus petit que le précédent empilé
+        int start[64], end[64], depth[64];
+        int sp = 0;
+
+        int depthLimit = 2 * (int)log2(size);
+        int start_round = 0, end_round = size, depth_round = 0; // end_round est exclu
+        while (true)
         {
-            rootSwaped = false;
-            left = root * 2 + 1;
-            right = root * 2 + 2; // left + 1;
-            //std::cout << "Root: " << root << "(" << this->collection.at(root) << "), Left: " << left;
-            if (left < size && collection.at(left) > collection.at(largest)) // largest = root à la premiere condition
+            if (end_round - start_round <= smallRangeCutoff<Compare>())
             {
-                //std::cout << "(" << this->collection.at(left) << ")";
-                largest = left;
+                smallSortRange(array, start_round, end_round, comp);
             }
-            //std::cout << ", Right: " << right;
-            if (right < size && collection.at(right) > collection.at(largest))
+            else if (depth_round > depthLimit)
             {
-                //std::cout << "(" << this->collection.at(right) << ")";
-                largest = right;
+                heapSortRange(array, start_round, end_round, comp);
             }
-            //std::cout << std::endl;
-            if (largest != root)
+            else
             {
-                swap(collection.at(root), collection.at(largest));
-                rootSwaped = true; // un enfant a changer du coup on doit revérifier la condition chez les enfants.
-                root = largest;    // changement de root pour la prochaine iteration
+                int p = partitionAroundPivot(array, start_round, end_round, comp);
+                depth_round++;
+                // on empile le plus grand subarray et on continue directement avec le plus petit
+                if (p - start_round < end_round - p - 1)
+                {
+                    start[sp] = p + 1;
+                    end[sp] = end_round;
+                    depth[sp++] = depth_round;
+                    end_round = p;
+                }
+                else
+                {
+                    start[sp] = start_round;
+                    end[sp] = p;
+                    depth[sp++] = depth_round;
+                    start_round = p + 1;
+                }
+                continue;
             }
 
-        } while (rootSwaped);
+            if (sp == 0)
+                break;
+            start_round = start[--sp];
+            end_round = end[sp];
+            depth_round = depth[sp];
+        }
+    }
+
+    template <typename T>
+    template <typename Compare>
+    int MyCollection<T>::medianOfThree(T *const array, int const a, int const b, int const c, Compare comp)
+    {
+        if (comp(array[a], array[b]))
+        {
+            if (comp(array[b], array[c]))
+                return b;
+            return comp(array[a], array[c]) ? c : a;
+        }
+        if (comp(array[a], array[c]))
+            return a;
+        return comp(array[b], array[c]) ? c : b;
+    }
+
+    /**
+     * Médiane de trois pour les petits subarrays, ninther (médiane des médianes de trois triplets) au dela de 128 elements.
+     */
+    template <typename T>
+    template <typename Compare>
+    int MyCollection<T>::choosePivot(T *const array, int const start, int const end, Compare comp)
+    {
+        int size = end - start;
+        int mid = start + size / 2;
+        if (size <= 128)
+            return medianOfThree(array, start, mid, end - 1, comp);
+
+        int step = size / 8;
+        int first = medianOfThree(array, start, start + step, start + 2 * step, comp);
+        int second = medianOfThree(array, mid - step, mid, mid + step, comp);
+        int third = medianOfThree(array, end - 1 - 2 * step, end - 1 - step, end - 1, comp);
+        return medianOfThree(array, first, second, third, comp);
     }
 
     /**
-     * Heapify va se charger de faire remonter le min vers la racine.
-     * @param size pour ignorer les derniers elements (déja triées)
-     * @param root nous permet de selectionner qu'une partie de l'arbre vu qu'on doit commencer du bas vers le haut pour trouver le min
-     * A chaque iteration on doit verifier que l'enfant qui recoit la valeur du parent respecte la condition (contient la valeur la plus petite).
-     *  - Par exemple quand le root contient le max cela arrivera souvent.
+     * Partition de Hoare autour du pivot, qui est d'abord placé au debut du subarray [start, end).
+     * Les deux index s'arretent sur les elements égaux au pivot, ainsi les doublons sont répartis des deux cotés.
+     * @return la position finale du pivot
+     */
+    template <typename T>
+    template <typename Compare>
+    int MyCollection<T>::partitionAroundPivot(T *const array, int const start, int const end, Compare comp)
+    {
+        return partitionAroundPivot(array, start, end, choosePivot(array, start, end, comp), comp);
+    }
+
+    // pareil avec un pivot déja choisi (array[pivotIndex])
+    template <typename T>
+    template <typename Compare>
+    int MyCollection<T>::partitionAroundPivot(T *const array, int const start, int const end, int const pivotIndex, Compare comp)
+    {
+        std::swap(array[start], array[pivotIndex]);
+        T const &pivot = array[start]; // le pivot ne bouge pas pendant la boucle
+
+        int i = start, j = end;
+        while (true)
+        {
+            do
+                i++;
+            while (i < end && comp(array[i], pivot));
+            do
+            {
+                j--;
+                MYCOLLECTION_CHECK_RANGE(j, start, end);
+            } while (comp(pivot, array[j])); // s'arrete au plus tard sur le pivot lui même
+            if (i >= j)
+                break;
+            std::swap(array[i], array[j]);
+        }
+        // array[j] n'est pas aprés le pivot: on peut les échanger
+        std::swap(array[start], array[j]);
+        return j;
+    }
+
+    /**
+     * Introselect: la partition de introSort, mais on ne continue que du coté qui contient k.
+     * Aprés 2*log2(n) partitions le pivot devient la médiane des médianes, qui garantit au moins 30% d'elements de chaque coté: O(n) dans tous les cas.
+     * A la fin array[k] est l'element de rang k, [0, k) ne passe pas aprés lui et (k, size) pas avant.
+     */
+    template <typename T>
+    template <typename Compare>
+    void MyCollection<T>::selectLoop(T *const array, int const size, int const k, Compare comp)
+    {
+        int depthLimit = 2 * (int)log2(size);
+        int start = 0, end = size, depth = 0;
+        while (end - start > smallRangeCutoff<Compare>())
+        {
+            int p = depth++ > depthLimit ? partitionAroundPivot(array, start, end, medianOfMedians(array, start, end, comp), comp)
+                                         : partitionAroundPivot(array, start, end, comp);
+            if (k == p)
+                return;
+            if (k < p)
+                end = p;
+            else
+                start = p + 1;
+        }
+        smallSortRange(array, start, end, comp);
+    }
+
+    /**
+     * Selection de plusieurs rangs (croissants, sans doublons) dans [start, end): chaque partition sert à tous les rangs,
+     * ceux avant le pivot continuent à gauche et ceux aprés à droite. depthLeft: partitions avant de passer à la médiane des médianes.
+     */
+    template <typename T>
+    template <typename Compare>
+    void MyCollection<T>::multiSelect(T *const array, int const start, int const end, int const *const ranks, int const count, int const depthLeft, Compare comp)
+    {
+        if (count == 0)
+            return;
+        if (end - start <= smallRangeCutoff<Compare>())
+        {
+            smallSortRange(array, start, end, comp);
+            return;
+        }
+        int p = depthLeft <= 0 ? partitionAroundPivot(array, start, end, medianOfMedians(array, start, end, comp), comp)
+                               : partitionAroundPivot(array, start, end, comp);
+        int const left = std::lower_bound(ranks, ranks + count, p) - ranks;
+        int const right = left < count && ranks[left] == p ? left + 1 : left;
+        multiSelect(array, start, p, ranks, left, depthLeft - 1, comp);
+        multiSelect(array, p + 1, end, ranks + right, count - right, depthLeft - 1, comp);
+    }
+
+    /**
+     * Pivot de Blum, Floyd, Pratt, Rivest et Tarjan: les médianes des groupes de 5 sont rangées au début de [start, end),
+     * puis selectLoop prend la médiane de ces médianes.
+     * @return l'index du pivot
      */
     template <typename T>
-    void MyCollection<T>::heapifyDescending(int size, int root)
+    template <typename Compare>
+    int MyCollection<T>::medianOfMedians(T *const array, int const start, int const end, Compare comp)
+    {
+        int groups = 0;
+        for (int group = start; group + 5 <= end; group += 5)
+        {
+            insertionSortRange(array, group, group + 5, comp);
+            std::swap(array[start + groups++], array[group + 2]);
+        }
+        if (groups == 0)
+            return start + (end - start) / 2;
+        selectLoop(array + start, groups, groups / 2, comp);
+        return start + groups / 2;
+    }
+
+    /**
+     * QuickSort avec une partition en trois (drapeau hollandais): [< pivot][== pivot][> pivot].
+     * Les elements égaux au pivot sont à leur place finale et on ne recurse jamais dessus,
+     * du coup sur une collection avec peu de valeurs différentes le tri est presque linéaire.
+     * Même garde-fous que introSort: ninther, insertion sort sur les petits subarrays, pile bornée et repli sur le heap sort.
+     */
+    template <typename T>
+    void MyCollection<T>::quickSort3Way(bool ascending)
+    {
+        if (this->sorted && !(ascending ^ this->ascending)) // if already sorted in wanted order: !(a^b) means a==b.
+        {
+            std::cout << "Collection is already sorted!" << std::endl;
+            return;
+        }
+
+        if (this->collection.size() > 1)
+        {
+            if (ascending)
+                quickSort3WayLoop(&this->collection[0], this->collection.size(), std::less<T>());
+            else
+                quickSort3WayLoop(&this->collection[0], this->collection.size(), std::greater<T>());
+        }
+        this->sorted = true;
+        this->ascending = ascending;
+    }
+
+    template <typename T>
+    template <typename Compare>
+    void MyCollection<T>::quickSort3WayLoop(T *const array, int const size, Compare comp)
     {
-        int left, right;
-        int smallest = root;
-        bool rootSwaped;
-        do
+        int start[64], end[64], depth[64];
+        int sp = 0;
+
+        int depthLimit = 2 * (int)log2(size);
+        int start_round = 0, end_round = size, depth_round = 0; // end_round est exclu
+        int lessEnd, greaterStart;
+        while (true)
         {
-            rootSwaped = false;
-            left = root * 2 + 1;
-            right = root * 2 + 2; // left + 1;
-            //std::cout << "Root: " << root << "(" << this->collection.at(root) << "), Left: " << left;
-            if (left < size && collection.at(left) < collection.at(smallest)) // smallest = root à la premiere condition
+            if (end_round - start_round <= smallRangeCutoff<Compare>())
             {
-                //std::cout << "(" << this->collection.at(left) << ")";
-                smallest = left;
+                smallSortRange(array, start_round, end_round, comp);
             }
-            //std::cout << ", Right: " << right;
-            if (right < size && collection.at(right) < collection.at(smallest))
+            else if (depth_round > depthLimit)
             {
-                //std::cout << "(" << this->collection.at(right) << ")";
-                smallest = right;
+                heapSortRange(array, start_round, end_round, comp);
             }
-            //std::cout << std::endl;
-            if (smallest != root)
+            else
             {
-                swap(collection.at(root), collection.at(smallest));
-                rootSwaped = true; // un enfant a changer du coup on doit revérifier la condition chez les enfants.
-                root = smallest;   // changement de root pour la prochaine iteration
+                partitionThreeWay(array, start_round, end_round, lessEnd, greaterStart, comp);
+                depth_round++;
+                // [lessEnd, greaterStart) est déja à sa place: on empile le plus grand des deux cotés, on continue avec le plus petit
+                if (lessEnd - start_round < end_round - greaterStart)
+                {
+                    start[sp] = greaterStart;
+                    end[sp] = end_round;
+                    depth[sp++] = depth_round;
+                    end_round = lessEnd;
+                }
+                else
+                {
+                    start[sp] = start_round;
+                    end[sp] = lessEnd;
+                    depth[sp++] = depth_round;
+                    start_round = greaterStart;
+                }
+                continue;
             }
 
-        } while (rootSwaped);
+            if (sp == 0)
+                break;
+            start_round = start[--sp];
+            end_round = end[sp];
+            depth_round = depth[sp];
+        }
     }
 
+    /**
+     * Dijkstra: [start, lessEnd) passe avant le pivot, [lessEnd, i) est égal au pivot, [i, greaterStart) n'est pas encore vu
+     * et [greaterStart, end) passe aprés le pivot.
+     */
     template <typename T>
-    void MyCollection<T>::heapSort(bool ascending)
+    template <typename Compare>
+    void MyCollection<T>::partitionThreeWay(T *const array, int const start, int const end, int &lessEnd, int &greaterStart, Compare comp)
+    {
+        T const pivot = array[choosePivot(array, start, end, comp)]; // copie: la case du pivot va bouger
+        lessEnd = start;
+        greaterStart = end;
+        int i = start;
+        while (i < greaterStart)
+        {
+            if (comp(array[i], pivot))
+                std::swap(array[lessEnd++], array[i++]);
+            else if (comp(pivot, array[i]))
+                std::swap(array[i], array[--greaterStart]); // l'element récupéré n'est pas encore vu, i ne bouge pas
+            else
+                i++;
+        }
+    }
+
+    /**
+     * BlockQuicksort (Edelkamp & Weiß): dans la partition, le if de quickSort se trompe une fois sur deux sur des données aléatoires.
+     * Ici on compare un bloc de PARTITION_BLOCK_SIZE elements de chaque coté et on note sans branchement (offsets[num] = i; num += comp)
+     * les positions des elements qui sont du mauvais coté, puis on les échange deux à deux.
+     * Pas de .at() dans les boucles, on travaille directement sur des pointeurs.
+     * Même garde-fous que introSort: ninther, insertion sort sur les petits subarrays, pile bornée et repli sur le heap sort.
+     */
+    template <typename T>
+    void MyCollection<T>::blockQuickSort(bool ascending)
     {
         if (this->sorted && !(ascending ^ this->ascending)) // if already sorted in wanted order: !(a^b) means a==b.
         {
@@ -782,55 +1304,915 @@ namespace mycollections
             return;
         }
 
-        if (ascending)
+        if (this->collection.size() > 1)
+        {
+            if (ascending)
+                blockQuickSortLoop(&this->collection[0], this->collection.size(), std::less<T>());
+            else
+                blockQuickSortLoop(&this->collection[0], this->collection.size(), std::greater<T>());
+        }
+        this->sorted = true;
+        this->ascending = ascending;
+    }
+
+    template <typename T>
+    template <typename Compare>
+    void MyCollection<T>::blockQuickSortLoop(T *const array, int const size, Compare comp)
+    {
+        int start[64], end[64], depth[64];
+        int sp = 0;
+
+        int depthLimit = 2 * (int)log2(size);
+        int start_round = 0, end_round = size, depth_round = 0; // end_round est exclu
+        while (true)
         {
-            // On commence par faire un premier heapify pour avoir un arbre où chaque parent est plus grand ou égale à ses descendants.
-            for (int i = (this->collection.size() / 2) - 1; i >= 0; i--)
+            if (end_round - start_round <= smallRangeCutoff<Compare>())
+            {
+                smallSortRange(array, start_round, end_round, comp);
+            }
+            else if (depth_round > depthLimit)
             {
-                heapifyAscending(this->collection.size(), i);
+                heapSortRange(array, start_round, end_round, comp);
             }
-            //std::cout << "First Heapify done: " << *this << std::endl;
-            /*
-            - Maintenant on va utiliser l'arbre obtenu pour trier notre collection dans l'ordre voulue.
-            - Le premier heapify nous assure qu'un noeud est plus grand que ses descendants, i.e. il a comme enfants les plus grandes valeurs de ses sous-arbres
-            - On faisant ca on forme un nouvelle arbre ou le root est le dernier elements de la collection (une feuille).
-                - Du coup on doit remonter son parent et le comparer avec l'autre sous-arbre.
-            */
-            for (int i = this->collection.size() - 1; i >= 0; i--)
+            else
             {
-                swap(this->collection.at(i), this->collection.at(0));
-                /* Dans ce heapify on ne deplace que la valeur du nouveau root à son ancienne place (dernier element).
-                On a pas besoin de le refaire pour tous les noeuds avec enfants, un noeud va perdre un enfants à chaque iteration c'est tout.
-                */
-                heapifyAscending(i, 0);
-                //std::cout << "Heapify (" << i << ") done: " << *this << std::endl;
+                std::swap(array[start_round], array[choosePivot(array, start_round, end_round, comp)]);
+                /**
+                 * Si l'element juste avant le subarray (déja à sa place, donc pas plus grand que les elements du subarray)
+                 * est égal au pivot, tous les elements égaux au pivot sont à leur place finale: on les regroupe à gauche et on les saute.
+                 * Sans ça blockPartition met les doublons toujours du même coté et ne retire qu'un element par round.
+                 */
+                if (start_round > 0 && !comp(array[start_round - 1], array[start_round]))
+                {
+                    int equalEnd = start_round + 1;
+                    for (int i = start_round + 1; i < end_round; i++)
+                        if (!comp(array[start_round], array[i]))
+                            std::swap(array[equalEnd++], array[i]);
+                    start_round = equalEnd;
+                    continue;
+                }
+
+                int p = blockPartition(array, start_round, end_round, comp);
+                depth_round++;
+                if (p - start_round < end_round - p - 1)
+                {
+                    start[sp] = p + 1;
+                    end[sp] = end_round;
+                    depth[sp++] = depth_round;
+                    end_round = p;
+                }
+                else
+                {
+                    start[sp] = start_round;
+                    end[sp] = p;
+                    depth[sp++] = depth_round;
+                    start_round = p + 1;
+                }
+                continue;
             }
+
+            if (sp == 0)
+                break;
+            start_round = start[--sp];
+            end_round = end[sp];
+            depth_round = depth[sp];
         }
-        else // descending
+    }
+
+    /**
+     * Partition de [start, end) autour du pivot qui est à start: [< pivot][pivot][>= pivot].
+     * Le pivot est une médiane, il existe donc un element >= pivot aprés lui, ce qui permet les premiers scans sans test de borne.
+     * offsetsLeft contient les positions (depuis leftBase) des elements >= pivot du bloc de gauche,
+     * offsetsRight les distances (depuis rightBase) des elements < pivot du bloc de droite.
+     * @return la position finale du pivot
+     */
+    template <typename T>
+    template <typename Compare>
+    int MyCollection<T>::blockPartition(T *const array, int const start, int const end, Compare comp)
+    {
+        T *const begin = array + start;
+        T pivot = std::move(*begin);
+        T *first = begin;
+        T *last = array + end;
+
+        // premier element >= pivot (les vérifications portent sur la prochaine case lue)
+        while (comp(*++first, pivot))
+            MYCOLLECTION_CHECK_RANGE(first + 1, begin, array + end);
+        // dernier element < pivot, on doit tester la borne si aucun element n'est plus petit que le pivot à gauche
+        if (first - 1 == begin)
+            while (first < last && !comp(*--last, pivot))
+                ;
+        else
+            while (!comp(*--last, pivot))
+                MYCOLLECTION_CHECK_RANGE(last - 1, begin, array + end);
+
+        if (first < last)
         {
-            // On commence par faire un premier heapify pour avoir un arbre où chaque parent est plus petit ou égale à ses descendants.
-            for (int i = (this->collection.size() / 2) - 1; i >= 0; i--)
+            std::swap(*first, *last);
+            ++first;
+
+            unsigned char offsetsLeft[PARTITION_BLOCK_SIZE], offsetsRight[PARTITION_BLOCK_SIZE];
+            T *leftBase = first;
+            T *rightBase = last;
+            int numLeft = 0, numRight = 0, startLeft = 0, startRight = 0;
+
+            while (first < last)
+            {
+                // les blocs sont plus petits à la fin quand il reste moins de 2 * PARTITION_BLOCK_SIZE elements
+                int numUnknown = last - first;
+                int leftSplit = numLeft == 0 ? (numRight == 0 ? numUnknown / 2 : numUnknown) : 0;
+                int rightSplit = numRight == 0 ? (numUnknown - leftSplit) : 0;
+                leftSplit = std::min(leftSplit, PARTITION_BLOCK_SIZE);
+                rightSplit = std::min(rightSplit, PARTITION_BLOCK_SIZE);
+
+                for (int i = 0; i < leftSplit; i++)
+                {
+                    offsetsLeft[numLeft] = i;
+                    numLeft += !comp(*first, pivot); // pas de if: l'offset est écrasé si l'element est du bon coté
+                    ++first;
+                }
+                for (int i = 1; i <= rightSplit; i++)
+                {
+                    offsetsRight[numRight] = i;
+                    numRight += comp(*--last, pivot);
+                }
+
+                int num = std::min(numLeft, numRight);
+                for (int i = 0; i < num; i++)
+                {
+                    MYCOLLECTION_CHECK_RANGE(leftBase + offsetsLeft[startLeft + i], begin, array + end);
+                    MYCOLLECTION_CHECK_RANGE(rightBase - offsetsRight[startRight + i], begin, array + end);
+                    std::swap(leftBase[offsetsLeft[startLeft + i]], *(rightBase - offsetsRight[startRight + i]));
+                }
+                numLeft -= num;
+                numRight -= num;
+                startLeft += num;
+                startRight += num;
+
+                if (numLeft == 0)
+                {
+                    startLeft = 0;
+                    leftBase = first;
+                }
+                if (numRight == 0)
+                {
+                    startRight = 0;
+                    rightBase = last;
+                }
+            }
+
+            // il reste des elements du mauvais coté dans un seul des deux blocs: on les pousse au bord du milieu
+            if (numLeft)
             {
-                heapifyDescending(this->collection.size(), i);
+                while (numLeft--)
+                    std::swap(leftBase[offsetsLeft[startLeft + numLeft]], *--last);
+                first = last;
             }
-            /*
-            - Maintenant on va utiliser l'arbre obtenu pour trier notre collection dans l'ordre voulue.
-            - Le premier heapify nous assure qu'un noeud est plus petit que ses descendants, i.e. il a comme enfants les plus petites valeurs de ses sous-arbres.
-            - On faisant ca on forme un nouvelle arbre ou le root est le dernier elements de la collection (une feuille).
-                - Du coup on doit remonter son parent et le comparer avec l'autre sous-arbre.
-            */
-            for (int i = this->collection.size() - 1; i >= 0; i--)
+            if (numRight)
             {
-                swap(this->collection.at(i), this->collection.at(0));
-                /* Dans ce heapify on ne deplace que la valeur du nouveau root à son ancienne place (dernier element).
-                On a pas besoin de le refaire pour tous les noeuds avec enfants, un noeud va perdre un enfants à chaque iteration c'est tout.
-                */
-                heapifyDescending(i, 0);
-                //std::cout << "Heapify (" << i << ") done: " << *this << std::endl;
+                while (numRight--)
+                    std::swap(*(rightBase - offsetsRight[startRight + numRight]), *first++);
+                last = first;
             }
         }
 
+        // first - 1 est le dernier element < pivot (ou begin lui même)
+        T *pivotPosition = first - 1;
+        *begin = std::move(*pivotPosition);
+        *pivotPosition = std::move(pivot);
+        return pivotPosition - array;
+    }
+
+    /**
+     * Samplesort parallèle en place (voir SampleSort.hpp): contrairement à mergeSortParallel pas de buffer de la taille de la collection,
+     * seulement quelques blocs par thread et par bucket. Les buckets sont finis avec blockQuickSort.
+     * @param threads 0 par défaut, i.e. autant de threads que de coeurs
+     */
+    template <typename T>
+    void MyCollection<T>::sampleSort(bool ascending, int threads)
+    {
+        if (this->sorted && !(ascending ^ this->ascending)) // if already sorted in wanted order: !(a^b) means a==b.
+        {
+            std::cout << "Collection is already sorted!" << std::endl;
+            return;
+        }
+
+        if (this->collection.size() > 1)
+        {
+            threads = effectiveThreads(threads, this->collection.size());
+            if (ascending)
+                SampleSorter<T, std::less<T>>::sort(&this->collection[0], this->collection.size(), threads, std::less<T>(), &MyCollection<T>::blockQuickSortLoop<std::less<T>>);
+            else
+                SampleSorter<T, std::greater<T>>::sort(&this->collection[0], this->collection.size(), threads, std::greater<T>(), &MyCollection<T>::blockQuickSortLoop<std::greater<T>>);
+        }
         this->sorted = true;
         this->ascending = ascending;
     }
-}
+
+    /**
+     * Radix sort LSD (voir RadixSort.hpp), sans aucune comparaison: O(n * nombre de chiffres).
+     * Le choix se fait à la compilation: si T n'a pas de clé radix (voir RadixKey.hpp: entiers, float/double, pair/tuple de ces types) c'est mergeSortRecursive qui est utilisé,
+     * qui est lui aussi stable.
+     */
+    template <typename T>
+    void MyCollection<T>::radixSort(bool ascending)
+    {
+        radixSortDispatch(ascending, std::integral_constant<bool, RadixKey<T>::sortable>());
+    }
+
+    template <typename T>
+    void MyCollection<T>::radixSortDispatch(bool ascending, std::true_type)
+    {
+        if (this->sorted && !(ascending ^ this->ascending)) // if already sorted in wanted order: !(a^b) means a==b.
+        {
+            std::cout << "Collection is already sorted!" << std::endl;
+            return;
+        }
+
+        if (this->collection.size() > 1)
+        {
+            std::vector<T> buffer(this->collection.size());
+            radixSortLSD(&this->collection[0], &buffer[0], this->collection.size(), !ascending);
+        }
+        this->sorted = true;
+        this->ascending = ascending;
+    }
+
+    template <typename T>
+    void MyCollection<T>::radixSortDispatch(bool ascending, std::false_type)
+    {
+        mergeSortRecursive(ascending);
+    }
+
+    /**
+     * Radix sort parallèle: une passe MSD avec un histogramme par thread puis chaque bucket est fini en LSD par un thread
+     * (voir RadixSort.hpp). Si T n'a pas de clé radix c'est mergeSortParallel qui est utilisé.
+     * @param threads 0 par défaut, i.e. autant de threads que de coeurs
+     */
+    template <typename T>
+    void MyCollection<T>::radixSortParallel(bool ascending, int threads)
+    {
+        radixSortParallelDispatch(ascending, threads, std::integral_constant<bool, RadixKey<T>::sortable>());
+    }
+
+    template <typename T>
+    void MyCollection<T>::radixSortParallelDispatch(bool ascending, int threads, std::true_type)
+    {
+        if (this->sorted && !(ascending ^ this->ascending)) // if already sorted in wanted order: !(a^b) means a==b.
+        {
+            std::cout << "Collection is already sorted!" << std::endl;
+            return;
+        }
+
+        if (this->collection.size() > 1)
+        {
+            std::vector<T> buffer(this->collection.size());
+            threads = effectiveThreads(threads, this->collection.size());
+            radixSortParallelMSD(&this->collection[0], &buffer[0], this->collection.size(), !ascending, threads);
+        }
+        this->sorted = true;
+        this->ascending = ascending;
+    }
+
+    template <typename T>
+    void MyCollection<T>::radixSortParallelDispatch(bool ascending, int threads, std::false_type)
+    {
+        mergeSortParallel(ascending, threads);
+    }
+
+    /**
+     * Counting sort en O(n + k), k = max - min + 1:
+     *  1- un passage (vectorisable) pour trouver le min et le max
+     *  2- si k <= COUNTING_SORT_RANGE_FACTOR * n, un passage pour l'histogramme et un pour réécrire la collection.
+     *     Les compteurs ne prennent pas plus de place que la collection, au lieu du buffer complet du mergeSort.
+     *  3- sinon, ou si T n'est pas un type entier (choix fait à la compilation), c'est radixSort qui est utilisé.
+     * Pour la collection de test (entre 0 et 2¹⁶) k = 65537 ce qui est tout petit devant une collection de 10 millions d'elements.
+     */
+    template <typename T>
+    void MyCollection<T>::countingSort(bool ascending)
+    {
+        countingSortDispatch(ascending, std::integral_constant<bool, std::is_integral<T>::value && !std::is_same<T, bool>::value>());
+    }
+
+    template <typename T>
+    void MyCollection<T>::countingSortDispatch(bool ascending, std::true_type)
+    {
+        if (this->sorted && !(ascending ^ this->ascending)) // if already sorted in wanted order: !(a^b) means a==b.
+        {
+            std::cout << "Collection is already sorted!" << std::endl;
+            return;
+        }
+        if (this->collection.size() <= 1)
+        {
+            this->sorted = true;
+            this->ascending = ascending;
+            return;
+        }
+
+        T min, max;
+        scanMinMax(&this->collection[0], this->collection.size(), min, max);
+        using Unsigned = typename std::make_unsigned<T>::type;
+        Unsigned range = (Unsigned)max - (Unsigned)min; // +1 plus bas, sinon débordement si toutes les valeurs du type sont présentes
+        if (range >= (Unsigned)COUNTING_SORT_RANGE_FACTOR * this->collection.size())
+        {
+            radixSort(ascending);
+            return;
+        }
+
+        countingSortRange(&this->collection[0], this->collection.size(), min, (std::size_t)range + 1, !ascending);
+        this->sorted = true;
+        this->ascending = ascending;
+    }
+
+    template <typename T>
+    void MyCollection<T>::countingSortDispatch(bool ascending, std::false_type)
+    {
+        radixSort(ascending);
+    }
+
+    /**
+     * Tri de chaînes par multikey quicksort (voir StringSort.hpp): le préfixe commun d'un groupe de chaînes n'est lu qu'une fois
+     * au lieu d'être recomparé à chaque comparaison, et les chaînes sont échangées (swap des pointeurs) au lieu d'être copiées.
+     * Choisi à la compilation: si T n'est pas une std::basic_string c'est blockQuickSort qui est utilisé.
+     */
+    template <typename T>
+    void MyCollection<T>::stringSort(bool ascending)
+    {
+        stringSortDispatch(ascending, std::integral_constant<bool, StringKey<T>::sortable>());
+    }
+
+    template <typename T>
+    void MyCollection<T>::stringSortDispatch(bool ascending, std::true_type)
+    {
+        if (this->sorted && !(ascending ^ this->ascending)) // if already sorted in wanted order: !(a^b) means a==b.
+        {
+            std::cout << "Collection is already sorted!" << std::endl;
+            return;
+        }
+
+        if (this->collection.size() > 1)
+            multikeyQuickSort(&this->collection[0], this->collection.size(), !ascending);
+        this->sorted = true;
+        this->ascending = ascending;
+    }
+
+    template <typename T>
+    void MyCollection<T>::stringSortDispatch(bool ascending, std::false_type)
+    {
+        blockQuickSort(ascending);
+    }
+
+    /**
+     * Le tri par défaut, choisi à chaque appel (pas stable):
+     *  - triée dans l'autre ordre: on retourne la collection, O(n)
+     *  - pas plus de smallSize elements: insertionSort
+     *  - des runs dans l'ordre voulu d'au moins adaptiveRunLength elements en moyenne: timSort
+     *  - T a une clé radix et la collection est assez grande pour sizeof(T) (radixMinSize32 ou radixMinSize64): countingSort pour les entiers
+     *    (qui passe lui même à radixSort si les valeurs sont trop étalées), radixSort sinon, radixSortParallel à partir de radixParallelMinSize
+     *  - sinon sampleSort à partir de parallelMinSize, blockQuickSort en dessous.
+     * Les runs viennent de l'analyse du constructeur ou de setCollection, refaite ici si la collection a changé depuis.
+     * Les seuils sont mesurés sur la machine au premier appel et gardés dans un fichier (voir SortCalibration.hpp).
+     */
+    template <typename T>
+    void MyCollection<T>::sort(bool ascending)
+    {
+        if (this->sorted && !(ascending ^ this->ascending)) // if already sorted in wanted order: !(a^b) means a==b.
+        {
+            std::cout << "Collection is already sorted!" << std::endl;
+            return;
+        }
+        int const size = this->collection.size();
+        if (this->sorted)
+        {
+            std::reverse(this->collection.begin(), this->collection.end());
+            this->ascending = ascending;
+            return;
+        }
+        if (!this->presortednessCurrent)
+        {
+            checkOrder(1, std::integral_constant<bool, IsOrdered<T>::value>());
+            if (this->sorted)
+            {
+                sort(ascending);
+                return;
+            }
+        }
+
+        SortConfig const &config = sortConfig();
+        long long const runs = ascending ? this->presortedness.runs : this->presortedness.reverseRuns;
+        int const radixMinSize = sizeof(T) <= 4 ? config.radixMinSize32 : config.radixMinSize64;
+        if (size <= config.smallSize)
+            insertionSort(ascending);
+        else if (size / runs >= config.adaptiveRunLength)
+            timSort(ascending);
+        else if (RadixKey<T>::sortable && size >= radixMinSize)
+        {
+            if (size >= config.radixParallelMinSize)
+                radixSortParallel(ascending);
+            else if (std::is_integral<T>::value)
+                countingSort(ascending);
+            else
+                radixSort(ascending);
+        }
+        else if (size >= config.parallelMinSize)
+            sampleSort(ascending);
+        else
+            blockQuickSort(ascending);
+    }
+
+    /**
+     * Tri avec n'importe quel comparateur, inliné à la compilation (pas d'appel indirect): sort<Greater>(), sort<std::greater<T>>()
+     * ou sort(lambda). Le tri est fait par blockQuickSortLoop (pas stable).
+     * Avec std::less/Less ou std::greater/Greater les attributs sorted et ascending sont mis à jour comme pour les autres tris,
+     * avec un autre comparateur la collection n'est plus considérée triée: son ordre n'est pas celui de T.
+     * En mode MYCOLLECTION_CHECK_COMPARATORS le comparateur est vérifié à chaque comparaison (voir Ordering.hpp).
+     */
+    template <typename T>
+    template <typename Compare, typename>
+    void MyCollection<T>::sort(Compare comp)
+    {
+        const int order = NaturalOrder<T, Compare>::value;
+        if (order != 0 && this->sorted && this->ascending == (order > 0))
+        {
+            std::cout << "Collection is already sorted!" << std::endl;
+            return;
+        }
+
+        if (this->collection.size() > 1)
+            blockQuickSortLoop(&this->collection[0], this->collection.size(), OrderPolicy<Compare>(comp));
+        this->sorted = order != 0;
+        if (order != 0)
+            this->ascending = order > 0;
+        this->presortednessCurrent = false;
+    }
+
+    /**
+     * Tri sur une clé de chaque element: sortBy(&Record::age), sortBy(&Record::name, Greater()), sortBy(&Record::getId)
+     * ou sortBy(lambda qui retourne la clé). La clé est recalculée à chaque comparaison, elle doit donc être rapide à obtenir.
+     * Aprés un sortBy la collection n'est plus considérée triée selon l'ordre de T.
+     */
+    template <typename T>
+    template <typename Projection, typename Compare>
+    void MyCollection<T>::sortBy(Projection projection, Compare comp)
+    {
+        using Projected = ProjectedCompare<Projection, Compare>;
+        if (this->collection.size() > 1)
+            blockQuickSortLoop(&this->collection[0], this->collection.size(), OrderPolicy<Projected>(Projected(projection, comp)));
+        this->sorted = false;
+        this->presortednessCurrent = false;
+    }
+
+    /**
+     * Argsort: la permutation qui trie la collection, permutation[i] est l'index du i-ème element dans l'ordre voulu.
+     * Ni la collection ni les attributs sorted et ascending ne changent. Stable: des elements égaux restent dans l'ordre de leurs index.
+     * Si T a une clé radix ce sont des paires (clé, index) compactes qui sont triées par radixSort (voir ArgSort.hpp),
+     * sinon les index sont triés par mergeSort en comparant collection[a] et collection[b].
+     * @tparam Index uint32_t par défaut ou uint64_t, doit pouvoir contenir taille - 1
+     */
+    template <typename T>
+    template <typename Index>
+    std::vector<Index> MyCollection<T>::argSort(bool ascending) const
+    {
+        std::vector<Index> permutation;
+        int size = this->collection.size();
+        if (size == 0)
+            return permutation;
+        if ((unsigned long long)(size - 1) > (unsigned long long)std::numeric_limits<Index>::max())
+        {
+            myprint::logger::log("Le type des index de argSort est trop petit pour la taille de la collection.\n", ERROR_LOG);
+            return permutation;
+        }
+
+        permutation.resize(size);
+        argSortRange(&this->collection[0], size, &permutation[0], ascending, std::integral_constant<bool, RadixKey<T>::sortable>());
+        return permutation;
+    }
+
+    template <typename T>
+    template <typename Index>
+    void MyCollection<T>::argSortRange(T const *const array, int const size, Index *const permutation, bool ascending, std::true_type)
+    {
+        argSortRadix(array, size, !ascending, permutation);
+    }
+
+    template <typename T>
+    template <typename Index>
+    void MyCollection<T>::argSortRange(T const *const array, int const size, Index *const permutation, bool ascending, std::false_type)
+    {
+        std::vector<Index> buffer(size);
+        for (int i = 0; i < size; i++)
+            permutation[i] = buffer[i] = (Index)i;
+
+        T const *const data = array;
+        if (ascending)
+            MyCollection<Index>::mergeSplitPingPong(&buffer[0], permutation, 0, size, [data](Index a, Index b)
+                                                    { return data[a] < data[b]; });
+        else
+            MyCollection<Index>::mergeSplitPingPong(&buffer[0], permutation, 0, size, [data](Index a, Index b)
+                                                    { return data[a] > data[b]; });
+    }
+
+    /**
+     * Tri clé/payload en structure of arrays: la collection contient les clés et payloads[i] est le payload de la clé i.
+     * Au lieu de trier des records (clé, payload) entiers, qui seraient copiés à chaque swap et à chaque merge,
+     * on trie seulement les clés avec des index de 32 bits (argSort), puis les clés et les payloads sont déplacés
+     * une seule fois chacun dans l'ordre de la permutation (permute).
+     * Stable: des clés égales gardent l'ordre dans lequel elles ont été insérées.
+     */
+    template <typename T>
+    template <typename Payload>
+    void MyCollection<T>::sortWithPayload(std::vector<Payload> &payloads, bool ascending)
+    {
+        if (payloads.size() != this->collection.size())
+        {
+            std::cerr << "sortWithPayload: there must be exactly one payload per element of the collection!" << std::endl;
+            return;
+        }
+        if (this->sorted && !(ascending ^ this->ascending)) // if already sorted in wanted order: !(a^b) means a==b.
+        {
+            std::cout << "Collection is already sorted!" << std::endl;
+            return;
+        }
+
+        std::vector<uint32_t> permutation = argSort<uint32_t>(ascending);
+        permute(this->collection, permutation);
+        permute(payloads, permutation);
+        this->sorted = true;
+        this->ascending = ascending;
+    }
+
+    /**
+     * Heap Sort permet d'avoir une complexité proche du quicksort et mergesort sans utiliser de mémoire en plus.
+     * Comme les subarrays dans merge sort et le stockage des index dans quicksort.
+     *
+     *  La collection va être lu comme un arbre binaire ou un noeud 'i' a ses enfants de droite et de gauche à 'i*2+1' et 'i*2+2' respectivement
+     * Avec cette logique la deuxieme moitié de la collection ne comprendra que des feuilles:
+     *  - Une collection de 11 elements [0..10] aura 6 feuilles: [0..4] sont des noeuds parents et [5..10] seront des feuilles
+
+     * Le heap sort fait en sorte de swaper un parent avec son plus grand (petit) descendants en commencant par le bas (index 4 dans l'exemple).
+     * En suivant cette méthode on aura à la fin d'une iteration le plus grand (petit) element comme racine. Ce dernier et deplacé vers sa place finale
+     * dans la collection. Et en refait la même chose sans le max (min) trouvé dans les iterations precendents jusqu'à avoir une collection triée.
+     */
+    template <typename T>
+    void MyCollection<T>::heapSort(bool ascending)
+    {
+        if (this->sorted && !(ascending ^ this->ascending)) // if already sorted in wanted order: !(a^b) means a==b.
+        {
+            std::cout << "Collection is already sorted!" << std::endl;
+            return;
+        }
+
+        if (this->collection.size() > 1)
+        {
+            if (ascending)
+                heapSortRange(&this->collection[0], 0, this->collection.size(), std::less<T>());
+            else
+                heapSortRange(&this->collection[0], 0, this->collection.size(), std::greater<T>());
+        }
+        this->sorted = true;
+        this->ascending = ascending;
+    }
+
+    /**
+     * Heapify (siftDown) va se charger de faire remonter le max (au sens du comparateur) vers la racine.
+     * @param size pour ignorer les derniers elements (déja triées)
+     * @param root nous permet de selectionner qu'une partie de l'arbre vu qu'on doit commencer du bas vers le haut pour trouver le max
+     * A chaque iteration on doit verifier que l'enfant qui recoit la valeur du parent respecte la condition (contient la valeur la plus grande).
+     *  - Par exemple quand le root contient le min cela arrivera souvent.
+     * Le root descend tant qu'un de ses enfants doit passer aprés lui dans l'ordre voulu.
+     */
+    template <typename T>
+    template <typename Compare>
+    void MyCollection<T>::siftDown(T *const heap, int const size, int root, Compare comp)
+    {
+        int child;
+        while ((child = root * 2 + 1) < size)
+        {
+            if (child + 1 < size && comp(heap[child], heap[child + 1]))
+                child++;
+            if (!comp(heap[root], heap[child]))
+                return;
+            std::swap(heap[root], heap[child]);
+            root = child;
+        }
+    }
+
+    /**
+     * heapSort sur le subarray [start, end), utilisé par heapSort et par introSort quand la partition dégénère.
+     * 1- un premier heapify de tous les noeuds parents, du bas vers le haut: chaque parent passe aprés ses descendants
+     * 2- le root (le max) est swappé avec le dernier element du heap, qui perd une case, et on refait un heapify du nouveau root
+     */
+    template <typename T>
+    template <typename Compare>
+    void MyCollection<T>::heapSortRange(T *const array, int const start, int const end, Compare comp)
+    {
+        T *const heap = array + start;
+        int size = end - start;
+        for (int i = size / 2 - 1; i >= 0; i--)
+            siftDown(heap, size, i, comp);
+        for (int i = size - 1; i > 0; i--)
+        {
+            std::swap(heap[0], heap[i]);
+            siftDown(heap, i, 0, comp);
+        }
+    }
+
+    /**
+     * K-way merge des shards (voir KWayMerge.hpp): arbre des perdants, log2(k) comparaisons par element, merge SIMD pour deux shards de u32, int32 ou float.
+     * Stable: à égalité les elements du premier shard passent avant. Rien n'est fait si un shard n'est pas trié.
+     * Plus rapide que de concaténer puis retrier, et la collection est triée ensuite.
+     */
+    template <typename T>
+    void MyCollection<T>::mergeFrom(std::vector<MyCollection<T>> const &shards, bool ascending)
+    {
+        mergeFromWith(shards, ascending, 1);
+    }
+
+    // chaque thread écrit une tranche de la sortie, découpée dans tous les shards par sélection multi-suites
+    template <typename T>
+    void MyCollection<T>::mergeFromParallel(std::vector<MyCollection<T>> const &shards, bool ascending, int threads)
+    {
+        mergeFromWith(shards, ascending, threads);
+    }
+
+    template <typename T>
+    bool MyCollection<T>::shardRuns(std::vector<MyCollection<T>> const &shards, bool ascending, std::vector<SortedRun<T>> &runs, std::vector<std::vector<T>> &reversed)
+    {
+        std::size_t reversedCount = 0;
+        for (MyCollection<T> const &shard : shards)
+        {
+            if (!shard.sorted)
+            {
+                std::cerr << "Collection is not sorted!" << std::endl;
+                return false;
+            }
+            reversedCount += shard.ascending != ascending && shard.collection.size() > 1;
+        }
+        reversed.reserve(reversedCount); // les pointeurs des runs restent valides
+        for (MyCollection<T> const &shard : shards)
+        {
+            if (shard.collection.empty())
+                continue;
+            T const *data = shard.collection.data();
+            if (shard.ascending != ascending && shard.collection.size() > 1)
+            {
+                reversed.emplace_back(shard.collection.rbegin(), shard.collection.rend());
+                data = reversed.back().data();
+            }
+            runs.push_back(SortedRun<T>{data, data + shard.collection.size()});
+        }
+        return true;
+    }
+
+    template <typename T>
+    void MyCollection<T>::mergeFromWith(std::vector<MyCollection<T>> const &shards, bool ascending, int threads)
+    {
+        std::vector<SortedRun<T>> runs;
+        std::vector<std::vector<T>> reversed;
+        if (!shardRuns(shards, ascending, runs, reversed))
+            return;
+
+        std::size_t total = 0;
+        for (SortedRun<T> const &run : runs)
+            total += run.size();
+        std::vector<T> merged(total);
+        if (ascending)
+            kWayMergeParallel(runs, merged.data(), threads, std::less<T>());
+        else
+            kWayMergeParallel(runs, merged.data(), threads, std::greater<T>());
+
+        this->collection.swap(merged);
+        this->sorted = true;
+        this->ascending = ascending;
+        this->presortednessCurrent = false;
+    }
+
+    /**
+     * Selection du rang k (introselect, voir selectLoop): O(n) au lieu du O(n*logn) d'un tri.
+     * Une collection triée n'est pas touchée (lecture directe), sinon elle est partitionnée autour de k et n'est plus considérée triée.
+     * @return l'element de rang k dans l'ordre voulu, T() si k est hors de la collection
+     */
+    template <typename T>
+    T MyCollection<T>::nthElement(int k, bool ascending)
+    {
+        int const size = this->collection.size();
+        if (k < 0 || k >= size)
+        {
+            std::cerr << "Index out of range!" << std::endl;
+            return T();
+        }
+        if (this->sorted)
+            return this->collection[ascending == this->ascending ? k : size - 1 - k];
+
+        if (ascending)
+            selectLoop(&this->collection[0], size, k, std::less<T>());
+        else
+            selectLoop(&this->collection[0], size, k, std::greater<T>());
+        this->sorted = false;
+        this->presortednessCurrent = false;
+        return this->collection[k];
+    }
+
+    // rang le plus proche: le premier rang k tel que k + 1 >= p% de la taille, -1 si p n'est pas dans [0, 100] ou si la collection est vide
+    template <typename T>
+    int MyCollection<T>::percentileRank(double const p) const
+    {
+        int const size = this->collection.size();
+        if (!(p >= 0 && p <= 100) || size == 0)
+        {
+            std::cerr << "Percentile out of range!" << std::endl;
+            return -1;
+        }
+        int const rank = (int)std::ceil(p / 100 * size) - 1;
+        return std::max(0, std::min(rank, size - 1));
+    }
+
+    template <typename T>
+    T MyCollection<T>::percentile(double p)
+    {
+        int const rank = percentileRank(p);
+        return rank < 0 ? T() : nthElement(rank);
+    }
+
+    /**
+     * Les rangs demandés sont triés puis tous sélectionnés par les mêmes partitions (multiSelect): p50, p90 et p99 coûtent à peine plus que p50 seul.
+     * @return les percentiles dans l'ordre de ps (T() pour un p hors de [0, 100])
+     */
+    template <typename T>
+    std::vector<T> MyCollection<T>::percentiles(std::vector<double> const &ps)
+    {
+        std::vector<int> wanted; // rang de chaque p, -1 si hors de [0, 100]
+        for (double p : ps)
+            wanted.push_back(percentileRank(p));
+        std::vector<int> ranks;
+        for (int rank : wanted)
+            if (rank >= 0)
+                ranks.push_back(rank);
+        std::sort(ranks.begin(), ranks.end());
+        ranks.erase(std::unique(ranks.begin(), ranks.end()), ranks.end());
+
+        int const size = this->collection.size();
+        bool const reversed = this->sorted && !this->ascending;
+        if (!ranks.empty() && !this->sorted)
+        {
+            multiSelect(&this->collection[0], 0, size, ranks.data(), ranks.size(), 2 * (int)log2(size), std::less<T>());
+            this->sorted = false;
+            this->presortednessCurrent = false;
+        }
+
+        std::vector<T> values;
+        values.reserve(ps.size());
+        for (int rank : wanted)
+            values.push_back(rank < 0 ? T() : this->collection[reversed ? size - 1 - rank : rank]);
+        return values;
+    }
+
+    /**
+     * Recherche binaire sans branchement (voir Search.hpp) dans l'ordre de la collection: std::less si ascending, std::greater sinon.
+     * @return l'index du premier element égal à value, -1 s'il n'y en a pas ou si la collection n'est pas triée
+     */
+    template <typename T>
+    int MyCollection<T>::binarySearch(T const &value) const
+    {
+        int index = lowerBound(value);
+        if (index < 0 || index == (int)this->collection.size())
+            return -1;
+        bool const found = this->ascending ? !std::less<T>()(value, this->collection[index]) : !std::greater<T>()(value, this->collection[index]);
+        return found ? index : -1;
+    }
+
+    /**
+     * binarySearch de n clés (voir lowerBoundBatch dans Search.hpp): les recherches avancent ensemble et leurs défauts de cache se recouvrent.
+     * Avec sortKeys, les clés sont d'abord triées dans l'ordre de la collection (comme argSort puis gather): deux clés voisines suivent presque le même chemin,
+     * déjà en cache. Utile pour de gros lots de clés sur une collection qui ne tient pas en cache, le tri coûte plus qu'il ne rapporte sinon.
+     * Tout out est à -1 si la collection n'est pas triée.
+     */
+    template <typename T>
+    void MyCollection<T>::searchBatch(T const *keys, std::size_t n, int64_t *out, bool sortKeys) const
+    {
+        if (!this->sorted)
+        {
+            std::cerr << "Collection is not sorted!" << std::endl;
+            std::fill(out, out + n, -1);
+            return;
+        }
+
+        // order[i] est l'index dans keys de la i-ème clé triée (argSortRange, comme argSort), vide si les clés restent dans l'ordre donné
+        std::vector<uint32_t> order;
+        std::vector<T> sortedKeys;
+        if (sortKeys && n > 1 && n <= (std::size_t)std::numeric_limits<int>::max())
+        {
+            order.resize(n);
+            argSortRange(keys, n, &order[0], this->ascending, std::integral_constant<bool, RadixKey<T>::sortable>());
+            sortedKeys.reserve(n);
+            for (std::size_t i = 0; i < n; i++) // gather sur un pointeur
+                sortedKeys.push_back(keys[order[i]]);
+            keys = sortedKeys.data();
+        }
+
+        T const *const data = this->collection.data();
+        int const size = this->collection.size();
+        if (this->ascending)
+            lowerBoundBatch(data, size, keys, n, out, std::less<T>());
+        else
+            lowerBoundBatch(data, size, keys, n, out, std::greater<T>());
+
+        // lowerBound -> index du premier egal ou -1, comme binarySearch
+        for (std::size_t i = 0; i < n; i++)
+        {
+            int64_t const index = out[i];
+            bool const found = index < size && (this->ascending ? !std::less<T>()(keys[i], data[index]) : !std::greater<T>()(keys[i], data[index]));
+            out[i] = found ? index : -1;
+        }
+
+        if (!order.empty())
+        {
+            std::vector<int64_t> positions(out, out + n);
+            for (std::size_t i = 0; i < n; i++)
+                out[order[i]] = positions[i];
+        }
+    }
+
+    template <typename T>
+    int MyCollection<T>::normalSearch(T const &value) const
+    {
+        return linearSearch(this->collection.data(), this->collection.size(), value);
+    }
+
+    template <typename T>
+    int MyCollection<T>::lowerBound(T const &value) const
+    {
+        if (!this->sorted)
+        {
+            std::cerr << "Collection is not sorted!" << std::endl;
+            return -1;
+        }
+        if (this->ascending)
+            return mycollections::lowerBound(this->collection.data(), this->collection.size(), value, std::less<T>());
+        return mycollections::lowerBound(this->collection.data(), this->collection.size(), value, std::greater<T>());
+    }
+
+    template <typename T>
+    int MyCollection<T>::upperBound(T const &value) const
+    {
+        if (!this->sorted)
+        {
+            std::cerr << "Collection is not sorted!" << std::endl;
+            return -1;
+        }
+        if (this->ascending)
+            return mycollections::upperBound(this->collection.data(), this->collection.size(), value, std::less<T>());
+        return mycollections::upperBound(this->collection.data(), this->collection.size(), value, std::greater<T>());
+    }
+
+    /**
+     * Les elements égaux à value sont collection[first, second), second - first est leur nombre. (-1, -1) si la collection n'est pas triée.
+     */
+    template <typename T>
+    std::pair<int, int> MyCollection<T>::equalRange(T const &value) const
+    {
+        int first = lowerBound(value);
+        if (first < 0)
+            return std::make_pair(-1, -1);
+        int size = this->collection.size();
+        if (this->ascending)
+            return std::make_pair(first, first + mycollections::upperBound(this->collection.data() + first, size - first, value, std::less<T>()));
+        return std::make_pair(first, first + mycollections::upperBound(this->collection.data() + first, size - first, value, std::greater<T>()));
+    }
+
+    /**
+     * Copie de la collection triée en disposition d'Eytzinger, pour beaucoup de recherches aprés un tri:
+     * aux grandes tailles la recherche binaire sur la collection fait un défaut de cache presque à chaque niveau, l'index non.
+     * Les recherches de l'index retournent les mêmes positions que celles de la collection. Index vide si la collection n'est pas triée.
+     */
+    template <typename T>
+    EytzingerIndex<T> MyCollection<T>::buildIndex() const
+    {
+        if (!this->sorted)
+        {
+            std::cerr << "Collection is not sorted!" << std::endl;
+            return EytzingerIndex<T>();
+        }
+        return EytzingerIndex<T>(this->collection.data(), this->collection.size(), this->ascending);
+    }
+
+    /**
+     * Modèle linéaire par morceaux de la collection triée (types numériques seulement): sur des clés presque uniformes,
+     * la position prédite est à quelques elements de la bonne et la recherche finit par un comptage SIMD.
+     * leaves: nombre de morceaux du modèle, 0 pour une feuille par LEARNED_INDEX_LEAF_SIZE elements. Index vide si la collection n'est pas triée.
+     * maxError() et modelSize() de l'index disent s'il vaut mieux que binarySearch ou buildIndex() pour ces données.
+     */
+    template <typename T>
+    LearnedIndex<T> MyCollection<T>::buildLearnedIndex(int leaves) const
+    {
+        if (!this->sorted)
+        {
+            std::cerr << "Collection is not sorted!" << std::endl;
+            return LearnedIndex<T>();
+        }
+        return LearnedIndex<T>(this->collection.data(), this->collection.size(), this->ascending, leaves);
+    }
+}
+
+#include "SortCalibration.hpp"
+#include "TopK.hpp"
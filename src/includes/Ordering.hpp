@@ -0,0 +1,138 @@
+#pragma once
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include <iostream>
+#include <cstdlib>
+
+namespace mycollections
+{
+    /**
+     * Comparateurs sans type fixé (comme std::less<> et std::greater<> en C++14), pour sort<Greater>() ou sortBy(&Record::age, Greater()).
+     */
+    struct Less
+    {
+        template <typename A, typename B>
+        bool operator()(A const &a, B const &b) const { return a < b; }
+    };
+
+    struct Greater
+    {
+        template <typename A, typename B>
+        bool operator()(A const &a, B const &b) const { return b < a; }
+    };
+
+    /**
+     * true si T a les opérateurs < et >, i.e. si MyCollection<T> peut vérifier si la collection est déja triée.
+     * Une collection de structures sans opérateurs peut quand même être triée avec sort(comp) ou sortBy(projection).
+     */
+    template <typename T, typename Enable = void>
+    struct IsOrdered : std::false_type
+    {
+    };
+
+    template <typename T>
+    struct IsOrdered<T, decltype((void)(std::declval<T const &>() < std::declval<T const &>()), (void)(std::declval<T const &>() > std::declval<T const &>()))> : std::true_type
+    {
+    };
+
+    /**
+     * L'ordre naturel d'un comparateur: 1 pour croissant, -1 pour décroissant, 0 pour un ordre quelconque.
+     * Permet de garder les attributs sorted et ascending à jour aprés un sort<Compare>().
+     */
+    template <typename T, typename Compare>
+    struct NaturalOrder : std::integral_constant<int, 0>
+    {
+    };
+
+    template <typename T>
+    struct NaturalOrder<T, std::less<T>> : std::integral_constant<int, 1>
+    {
+    };
+
+    template <typename T>
+    struct NaturalOrder<T, Less> : std::integral_constant<int, 1>
+    {
+    };
+
+    template <typename T>
+    struct NaturalOrder<T, std::greater<T>> : std::integral_constant<int, -1>
+    {
+    };
+
+    template <typename T>
+    struct NaturalOrder<T, Greater> : std::integral_constant<int, -1>
+    {
+    };
+
+    /**
+     * La clé d'un element: un pointeur sur attribut (&Record::age), un pointeur sur méthode const sans paramètre (&Record::name)
+     * ou n'importe quel appelable (lambda, foncteur). Tout est résolu à la compilation, pas d'appel indirect.
+     */
+    template <typename T, typename Class, typename Member>
+    Member const &project(T const &element, Member Class::*const member, typename std::enable_if<!std::is_function<Member>::value>::type * = 0)
+    {
+        return element.*member;
+    }
+
+    template <typename T, typename Class, typename Result>
+    Result project(T const &element, Result (Class::*const method)() const)
+    {
+        return (element.*method)();
+    }
+
+    template <typename T, typename Projection>
+    auto project(T const &element, Projection const &projection) -> decltype(projection(element))
+    {
+        return projection(element);
+    }
+
+    /**
+     * Compare les clés de deux elements, comp(projection(a), projection(b)).
+     */
+    template <typename Projection, typename Compare>
+    struct ProjectedCompare
+    {
+        Projection projection;
+        Compare comp;
+
+        ProjectedCompare(Projection projection, Compare comp) : projection(projection), comp(comp) {}
+
+        template <typename T>
+        bool operator()(T const &a, T const &b) const { return comp(project(a, projection), project(b, projection)); }
+    };
+
+    /**
+     * Comparateurs vérifiés (MYCOLLECTION_CHECK_COMPARATORS, voir l'option du même nom dans CMakeLists.txt), seulement pour sort<Compare>() et sortBy():
+     * les autres tris n'utilisent que std::less/std::greater.
+     * Chaque comparaison vérifie que le comparateur est un ordre strict: comp(a, b) && comp(b, a) est une erreur (ce qui couvre aussi comp(a, a)).
+     * Un comparateur invalide fait sortir les boucles non gardées des partitions du tableau, en mode normal rien n'est vérifié.
+     */
+    template <typename Compare>
+    struct CheckedCompare
+    {
+        Compare comp;
+
+        CheckedCompare(Compare comp) : comp(comp) {}
+
+        template <typename T>
+        bool operator()(T const &a, T const &b) const
+        {
+            bool result = comp(a, b);
+            if (result && comp(b, a))
+            {
+                std::cerr << "MyCollection: the comparator is not a strict weak ordering (comp(a, b) and comp(b, a) are both true)!" << std::endl;
+                std::abort();
+            }
+            return result;
+        }
+    };
+
+#ifdef MYCOLLECTION_CHECK_COMPARATORS
+    template <typename Compare>
+    using OrderPolicy = CheckedCompare<Compare>;
+#else
+    template <typename Compare>
+    using OrderPolicy = Compare;
+#endif
+}
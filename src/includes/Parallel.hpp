@@ -0,0 +1,37 @@
+#pragma once
+#include <vector>
+#include <thread>
+#include <algorithm>
+#include <cstddef>
+
+namespace mycollections
+{
+    // en dessous de cette taille par thread, lancer un thread coute plus cher que le travail à faire
+    const int PARALLEL_MIN_CHUNK = 1 << 14;
+
+    /**
+     * Nombre de threads effectif: 0 veut dire autant que de coeurs, et on ne donne jamais moins de PARALLEL_MIN_CHUNK elements à un thread.
+     */
+    inline int effectiveThreads(int threads, std::size_t size)
+    {
+        if (threads <= 0)
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        int maxUseful = std::max<std::size_t>(1, size / PARALLEL_MIN_CHUNK);
+        return std::min(threads, maxUseful);
+    }
+
+    /**
+     * Lance task(0..threads-1), le thread appelant execute task(0) lui même puis attend les autres.
+     */
+    template <typename Task>
+    void parallelFor(int threads, Task task)
+    {
+        std::vector<std::thread> workers;
+        workers.reserve(threads - 1);
+        for (int t = 1; t < threads; t++)
+            workers.emplace_back(task, t);
+        task(0);
+        for (std::size_t t = 0; t < workers.size(); t++)
+            workers[t].join();
+    }
+}
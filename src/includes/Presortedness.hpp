@@ -0,0 +1,84 @@
+#pragma once
+#include <vector>
+#include <algorithm>
+#include "Parallel.hpp"
+
+namespace mycollections
+{
+    // nombre d'elements échantillonnés pour estimer le taux d'inversions (PRESORTEDNESS_SAMPLE² / 2 comparaisons)
+    const int PRESORTEDNESS_SAMPLE = 256;
+
+    /**
+     * Ce qu'on sait de l'ordre d'une collection aprés un seul passage.
+     */
+    struct Presortedness
+    {
+        bool ascending = false;       // croissante au sens large (une collection constante l'est aussi)
+        bool descending = false;      // décroissante au sens large
+        bool allEqual = false;        // tous les elements sont égaux (ou moins de deux elements)
+        long long runs = 0;           // nombre de runs croissants maximaux: 1 si triée, taille si strictement décroissante
+        long long reverseRuns = 0;    // nombre de runs décroissants maximaux: 1 si triée à l'envers
+        double inversionRatio = 0.0;  // estimation de inversions / paires: 0 triée, ~0.5 au hasard, ~1 triée à l'envers
+    };
+
+    /**
+     * Un seul passage sur les paires voisines: on compte les descentes (a[i+1] < a[i]) et les montées (a[i] < a[i+1]).
+     * Pas de if dans la boucle: les comparaisons sont ajoutées aux compteurs, le compilateur peut vectoriser la boucle (pcmpgtd/psubd
+     * et équivalents) comme dans scanMinMax. Avec plusieurs threads chaque thread compte les paires de sa bande.
+     * Le taux d'inversions est estimé sur PRESORTEDNESS_SAMPLE elements pris à intervalles réguliers.
+     * @param threads 1 par défaut, 0 pour autant que de coeurs (jamais moins de PARALLEL_MIN_CHUNK paires par thread)
+     */
+    template <typename T>
+    Presortedness analyzePresortedness(T const *const array, int const size, int threads = 1)
+    {
+        Presortedness result;
+        if (size < 2)
+        {
+            result.ascending = result.descending = result.allEqual = true;
+            result.runs = result.reverseRuns = size;
+            return result;
+        }
+
+        int const pairs = size - 1;
+        threads = effectiveThreads(threads, pairs);
+        std::vector<long long> descents(threads, 0), ascents(threads, 0);
+        parallelFor(threads, [&](int t)
+                    {
+                        int const start = (long long)pairs * t / threads;
+                        int const end = (long long)pairs * (t + 1) / threads;
+                        int down = 0, up = 0; // une bande a moins de 2³¹ paires
+                        for (int i = start; i < end; i++)
+                        {
+                            down += array[i + 1] < array[i];
+                            up += array[i] < array[i + 1];
+                        }
+                        descents[t] = down;
+                        ascents[t] = up; });
+
+        long long down = 0, up = 0;
+        for (int t = 0; t < threads; t++)
+        {
+            down += descents[t];
+            up += ascents[t];
+        }
+        result.ascending = down == 0;
+        result.descending = up == 0;
+        result.allEqual = result.ascending && result.descending;
+        result.runs = down + 1;
+        result.reverseRuns = up + 1;
+
+        if (result.ascending)
+            return result; // aucune inversion
+
+        int const sample = std::min(size, PRESORTEDNESS_SAMPLE);
+        std::vector<int> positions(sample);
+        for (int k = 0; k < sample; k++)
+            positions[k] = (long long)k * (size - 1) / (sample - 1);
+        long long inversions = 0;
+        for (int p = 0; p < sample; p++)
+            for (int q = p + 1; q < sample; q++)
+                inversions += array[positions[q]] < array[positions[p]];
+        result.inversionRatio = (double)inversions / ((double)sample * (sample - 1) / 2);
+        return result;
+    }
+}
@@ -0,0 +1,159 @@
+#pragma once
+#include <type_traits>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <tuple>
+#include <utility>
+
+namespace mycollections
+{
+    /**
+     * Transforme un element en une clé non signée dont l'ordre des bits (comparaison non signée) est celui de l'element.
+     * C'est ce qui permet aux tris sans comparaison (radixSort, radixSortParallel) de trier autre chose que des entiers non signés.
+     * Pour l'ordre décroissant on inverse tous les bits de la clé, le tri reste croissant sur la clé (et stable).
+     * Un type sans transformation a sortable = false et les radix sorts se rabattent sur un tri par comparaison.
+     */
+    template <typename T, typename Enable = void>
+    struct RadixKey
+    {
+        static const bool sortable = false;
+    };
+
+    // plus petit type non signé d'au moins Bits bits
+    template <int Bits>
+    struct UnsignedOfBits
+    {
+        using type = typename std::conditional<Bits <= 8, uint8_t,
+                                               typename std::conditional<Bits <= 16, uint16_t,
+                                                                         typename std::conditional<Bits <= 32, uint32_t, uint64_t>::type>::type>::type;
+    };
+
+    // nombre de bits de la clé, 0 si le type n'a pas de clé
+    template <typename T, bool = RadixKey<T>::sortable>
+    struct RadixKeyBits
+    {
+        static const int value = 0;
+    };
+
+    template <typename T>
+    struct RadixKeyBits<T, true>
+    {
+        static const int value = sizeof(typename RadixKey<T>::Unsigned) * CHAR_BIT;
+    };
+
+    /**
+     * Entiers signés et non signés: le bit de signe est inversé pour que les négatifs passent avant les positifs.
+     */
+    template <typename T>
+    struct RadixKey<T, typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, bool>::value>::type>
+    {
+        static const bool sortable = true;
+        using Unsigned = typename std::make_unsigned<T>::type;
+
+        static Unsigned encode(T const &value, bool const descending)
+        {
+            Unsigned key = (Unsigned)value;
+            if (std::is_signed<T>::value)
+                key ^= (Unsigned)((Unsigned)1 << (sizeof(Unsigned) * CHAR_BIT - 1));
+            return descending ? (Unsigned)~key : key;
+        }
+    };
+
+    /**
+     * float et double (IEEE-754 signe/magnitude):
+     *  - positif: on met le bit de signe à 1 pour passer aprés tous les négatifs
+     *  - négatif: on inverse tous les bits, un négatif plus grand en valeur absolue a alors une clé plus petite
+     *  - -0.0 a la même clé que +0.0, comme pour l'opérateur == (le tri reste stable entre les deux)
+     *  - NaN: tous les NaN ont la clé maximale, ils sont donc toujours aprés +inf en ordre croissant (avant en décroissant)
+     *    et gardent leur ordre entre eux.
+     */
+    template <typename T>
+    struct RadixKey<T, typename std::enable_if<std::is_same<T, float>::value || std::is_same<T, double>::value>::type>
+    {
+        static const bool sortable = true;
+        using Unsigned = typename UnsignedOfBits<sizeof(T) * CHAR_BIT>::type;
+
+        static Unsigned encode(T const &value, bool const descending)
+        {
+            const Unsigned signBit = (Unsigned)1 << (sizeof(Unsigned) * CHAR_BIT - 1);
+            Unsigned key;
+            if (value != value)
+                key = ~(Unsigned)0;
+            else
+            {
+                T const normalized = value == 0 ? T(0) : value;
+                std::memcpy(&key, &normalized, sizeof(key));
+                key = (key & signBit) ? ~key : (key | signBit);
+            }
+            return descending ? (Unsigned)~key : key;
+        }
+    };
+
+    template <typename T>
+    struct IsTupleLike : std::false_type
+    {
+    };
+
+    template <typename First, typename Second>
+    struct IsTupleLike<std::pair<First, Second>> : std::true_type
+    {
+    };
+
+    template <typename... Elements>
+    struct IsTupleLike<std::tuple<Elements...>> : std::true_type
+    {
+    };
+
+    /**
+     * Concaténation des clés des elements d'un tuple, du premier (poids fort) au dernier (poids faible):
+     * l'ordre des clés est l'ordre lexicographique du tuple.
+     */
+    template <typename Tuple, std::size_t I = 0, std::size_t N = std::tuple_size<Tuple>::value>
+    struct CompositeKey
+    {
+        using Element = typename std::tuple_element<I, Tuple>::type;
+        using Next = CompositeKey<Tuple, I + 1, N>;
+        static const bool sortable = RadixKey<Element>::sortable && Next::sortable;
+        static const int bits = RadixKeyBits<Element>::value + Next::bits;
+
+        template <typename Unsigned>
+        static Unsigned encode(Tuple const &value, Unsigned key)
+        {
+            const int elementBits = RadixKeyBits<Element>::value;
+            key = elementBits >= (int)(sizeof(Unsigned) * CHAR_BIT) ? 0 : (Unsigned)(key << (elementBits % (sizeof(Unsigned) * CHAR_BIT)));
+            key |= (Unsigned)RadixKey<Element>::encode(std::get<I>(value), false);
+            return Next::encode(value, key);
+        }
+    };
+
+    template <typename Tuple, std::size_t N>
+    struct CompositeKey<Tuple, N, N>
+    {
+        static const bool sortable = true;
+        static const int bits = 0;
+
+        template <typename Unsigned>
+        static Unsigned encode(Tuple const &, Unsigned key)
+        {
+            return key;
+        }
+    };
+
+    /**
+     * std::pair et std::tuple dont tous les elements ont une clé, tant que la clé concaténée tient sur 64 bits
+     * (par exemple une paire de u32, ou un tuple int16_t, float, uint8_t).
+     */
+    template <typename T>
+    struct RadixKey<T, typename std::enable_if<IsTupleLike<T>::value>::type>
+    {
+        static const bool sortable = CompositeKey<T>::sortable && CompositeKey<T>::bits <= 64;
+        using Unsigned = typename UnsignedOfBits<CompositeKey<T>::bits>::type;
+
+        static Unsigned encode(T const &value, bool const descending)
+        {
+            Unsigned key = CompositeKey<T>::encode(value, (Unsigned)0);
+            return descending ? (Unsigned)~key : key;
+        }
+    };
+}
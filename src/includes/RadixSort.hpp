@@ -0,0 +1,220 @@
+#pragma once
+#include <vector>
+#include <type_traits>
+#include <algorithm>
+#include <climits>
+#include <atomic>
+#include "Parallel.hpp"
+#include "RadixKey.hpp"
+
+namespace mycollections
+{
+    // un chiffre de 11 bits pour les types de 32 bits et plus (3 passes pour 32 bits), 8 bits sinon
+    const int RADIX_WIDE_DIGIT_BITS = 11;
+    const int RADIX_NARROW_DIGIT_BITS = 8;
+
+    template <typename T>
+    T *radixSortLSDPasses(T *const array, T *const buffer, int const size, bool const descending, int const keyBits);
+
+    /**
+     * Radix sort LSD (chiffre de poids faible d'abord), stable.
+     * 1- Un seul passage sur la collection pour calculer les histogrammes de tous les chiffres
+     * 2- Un passage de distribution par chiffre, de la collection vers le buffer et inversement (ping-pong)
+     * 3- Si tous les elements ont le même chiffre (une case de l'histogramme vaut size) la passe est sautée:
+     *    par exemple les 16 bits de poids fort des valeurs de la collection de test (entre 0 et 2¹⁶).
+     * @param buffer au moins size elements, son contenu n'a pas d'importance
+     */
+    template <typename T>
+    void radixSortLSD(T *const array, T *const buffer, int const size, bool const descending)
+    {
+        T *result = radixSortLSDPasses(array, buffer, size, descending, sizeof(typename RadixKey<T>::Unsigned) * CHAR_BIT);
+        if (result != array)
+            std::move(result, result + size, array);
+    }
+
+    /**
+     * Les passes LSD sur les keyBits bits de poids faible de la clé seulement.
+     * @return array ou buffer, selon où se trouve le résultat aprés la dernière passe
+     */
+    template <typename T>
+    T *radixSortLSDPasses(T *const array, T *const buffer, int const size, bool const descending, int const keyBits)
+    {
+        using Key = RadixKey<T>;
+        using Unsigned = typename Key::Unsigned;
+        const int digitBits = sizeof(Unsigned) * CHAR_BIT >= 32 ? RADIX_WIDE_DIGIT_BITS : RADIX_NARROW_DIGIT_BITS;
+        const int radix = 1 << digitBits;
+        const Unsigned mask = (Unsigned)(radix - 1);
+        const int passes = (keyBits + digitBits - 1) / digitBits;
+
+        std::vector<int> histograms(passes * radix, 0);
+        for (int i = 0; i < size; i++)
+        {
+            Unsigned key = Key::encode(array[i], descending);
+            for (int p = 0; p < passes; p++)
+                histograms[p * radix + ((key >> (p * digitBits)) & mask)]++;
+        }
+
+        T *source = array;
+        T *destination = buffer;
+        for (int p = 0; p < passes; p++)
+        {
+            int *const offsets = &histograms[p * radix];
+            if (offsets[(Key::encode(source[0], descending) >> (p * digitBits)) & mask] == size)
+                continue; // même chiffre partout: la passe ne changerait rien
+
+            // histogramme -> position de départ de chaque chiffre
+            int sum = 0;
+            for (int d = 0; d < radix; d++)
+            {
+                int count = offsets[d];
+                offsets[d] = sum;
+                sum += count;
+            }
+            for (int i = 0; i < size; i++)
+            {
+                int digit = (Key::encode(source[i], descending) >> (p * digitBits)) & mask;
+                destination[offsets[digit]++] = std::move(source[i]);
+            }
+            std::swap(source, destination);
+        }
+        return source;
+    }
+
+    /**
+     * Radix sort parallèle, une passe MSD (chiffre de poids fort d'abord) puis du LSD dans chaque bucket:
+     * 1- On cherche les bits qui varient vraiment (OU des key ^ première clé), le chiffre MSD est pris sous le bit le plus haut
+     *    qui varie. Pour la collection de test (entre 0 et 2¹⁶) ce sont les bits 6 à 16 et non pas les 11 bits de poids fort, tous à 0.
+     * 2- Chaque thread calcule l'histogramme du chiffre MSD sur sa bande. Les sommes préfixes (bucket puis thread) donnent
+     *    à chaque thread sa propre position d'écriture dans chaque bucket: la distribution vers le buffer se fait sans synchronisation
+     *    et reste stable.
+     * 3- Les buckets sont indépendants: chaque thread en prend un, le trie en LSD sur les bits restants et le remet dans la collection.
+     * @param buffer au moins size elements, son contenu n'a pas d'importance
+     */
+    template <typename T>
+    void radixSortParallelMSD(T *const array, T *const buffer, int const size, bool const descending, int const threads)
+    {
+        using Key = RadixKey<T>;
+        using Unsigned = typename Key::Unsigned;
+        const int digitBits = sizeof(Unsigned) * CHAR_BIT >= 32 ? RADIX_WIDE_DIGIT_BITS : RADIX_NARROW_DIGIT_BITS;
+
+        std::vector<int> stripe(threads + 1);
+        for (int t = 0; t <= threads; t++)
+            stripe[t] = (long long)size * t / threads;
+
+        // 1- bits qui varient
+        Unsigned first = Key::encode(array[0], descending);
+        std::vector<Unsigned> varying(threads, 0);
+        parallelFor(threads, [&](int t)
+                    {
+                        Unsigned bits = 0;
+                        for (int i = stripe[t]; i < stripe[t + 1]; i++)
+                            bits |= Key::encode(array[i], descending) ^ first;
+                        varying[t] = bits; });
+        Unsigned bits = 0;
+        for (int t = 0; t < threads; t++)
+            bits |= varying[t];
+        if (bits == 0)
+            return; // tous égaux
+
+        int topBits = 0;
+        while (topBits < (int)(sizeof(Unsigned) * CHAR_BIT) && (bits >> topBits) != 0)
+            topBits++;
+        const int shift = std::max(0, topBits - digitBits);
+        const int radix = 1 << (topBits - shift);
+        const Unsigned mask = (Unsigned)(radix - 1);
+
+        // 2- histogrammes par thread puis distribution
+        std::vector<int> offsets(threads * radix, 0);
+        parallelFor(threads, [&](int t)
+                    {
+                        int *const counts = &offsets[t * radix];
+                        for (int i = stripe[t]; i < stripe[t + 1]; i++)
+                            counts[(Key::encode(array[i], descending) >> shift) & mask]++; });
+
+        std::vector<int> bucketStart(radix + 1);
+        int sum = 0;
+        for (int d = 0; d < radix; d++)
+        {
+            bucketStart[d] = sum;
+            for (int t = 0; t < threads; t++)
+            {
+                int count = offsets[t * radix + d];
+                offsets[t * radix + d] = sum;
+                sum += count;
+            }
+        }
+        bucketStart[radix] = size;
+
+        parallelFor(threads, [&](int t)
+                    {
+                        int *const positions = &offsets[t * radix];
+                        for (int i = stripe[t]; i < stripe[t + 1]; i++)
+                            buffer[positions[(Key::encode(array[i], descending) >> shift) & mask]++] = std::move(array[i]); });
+
+        // 3- chaque bucket est fini indépendamment, du buffer vers la collection
+        std::atomic<int> next(0);
+        parallelFor(threads, [&](int)
+                    {
+                        int d;
+                        while ((d = next++) < radix)
+                        {
+                            int start = bucketStart[d];
+                            int length = bucketStart[d + 1] - start;
+                            T *result = buffer + start;
+                            if (shift > 0 && length > 1)
+                                result = radixSortLSDPasses(buffer + start, array + start, length, descending, shift);
+                            if (result != array + start)
+                                std::move(result, result + length, array + start);
+                        } });
+    }
+
+    /**
+     * Min et max en un seul passage. Pas de if dans la boucle et quatre accumulateurs indépendants:
+     * le compilateur peut vectoriser la boucle (pminud/pmaxud et équivalents) au lieu de dépendre de la prédiction de branchement.
+     */
+    template <typename T>
+    void scanMinMax(T const *const array, int const size, T &min, T &max)
+    {
+        T mins[4] = {array[0], array[0], array[0], array[0]};
+        T maxs[4] = {array[0], array[0], array[0], array[0]};
+        int i = 0;
+        for (; i + 4 <= size; i += 4)
+        {
+            for (int lane = 0; lane < 4; lane++)
+            {
+                mins[lane] = array[i + lane] < mins[lane] ? array[i + lane] : mins[lane];
+                maxs[lane] = array[i + lane] > maxs[lane] ? array[i + lane] : maxs[lane];
+            }
+        }
+        for (; i < size; i++)
+        {
+            mins[0] = array[i] < mins[0] ? array[i] : mins[0];
+            maxs[0] = array[i] > maxs[0] ? array[i] : maxs[0];
+        }
+        min = std::min(std::min(mins[0], mins[1]), std::min(mins[2], mins[3]));
+        max = std::max(std::max(maxs[0], maxs[1]), std::max(maxs[2], maxs[3]));
+    }
+
+    /**
+     * Counting sort pour les entiers dont toutes les valeurs sont dans [min, max]: un passage pour l'histogramme,
+     * un passage pour réécrire les valeurs. Deux entiers égaux sont indiscernables, il n'y a donc pas besoin de les déplacer.
+     * @param range max - min + 1, les compteurs prennent range entiers de mémoire
+     */
+    template <typename T>
+    void countingSortRange(T *const array, int const size, T const min, std::size_t const range, bool const descending)
+    {
+        using Unsigned = typename std::make_unsigned<T>::type;
+        std::vector<int> counts(range, 0);
+        for (int i = 0; i < size; i++)
+            counts[(Unsigned)((Unsigned)array[i] - (Unsigned)min)]++; // le cast final évite la promotion en int des petits types
+
+        int position = 0;
+        for (std::size_t v = 0; v < range; v++)
+        {
+            std::size_t value = descending ? range - 1 - v : v;
+            T const element = (T)((Unsigned)min + (Unsigned)value);
+            std::fill(array + position, array + position + counts[value], element);
+            position += counts[value];
+        }
+    }
+}
@@ -0,0 +1,433 @@
+#pragma once
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <random>
+#include <algorithm>
+#include <cstdint>
+#include "Parallel.hpp"
+#include "BoundsCheck.hpp"
+
+namespace mycollections
+{
+    // en dessous de cette taille le samplesort laisse la place au tri de base
+    const int SAMPLESORT_MIN_SIZE = 1 << 16;
+    // taille d'un bloc en octets pour la redistribution
+    const int SAMPLESORT_BLOCK_BYTES = 1024;
+    // au plus 2^SAMPLESORT_MAX_LEVELS buckets (plus les buckets d'égalité)
+    const int SAMPLESORT_MAX_LEVELS = 7;
+    // nombre d'echantillons par bucket pour choisir les splitters
+    const int SAMPLESORT_OVERSAMPLING = 16;
+    // au dela on laisse le tri de base finir les buckets
+    const int SAMPLESORT_MAX_DEPTH = 3;
+
+    /**
+     * Samplesort parallèle en place, inspiré de IPS4o (Axtmann, Witt, Ferizovic, Sanders).
+     * 1- Les splitters sont choisis dans un échantillon trié et rangés dans un arbre binaire (ordre BFS) pour classer un element
+     *    sans branchement. Un element égal à un splitter va dans un bucket d'égalité qui n'a plus besoin d'être trié.
+     * 2- Chaque thread classe sa bande de la collection dans des buffers d'un bloc par bucket. Un buffer plein est réécrit
+     *    au debut de la bande (là où les elements ont déja été lus), la bande finit donc avec des blocs pleins puis du vide.
+     * 3- Les blocs sont déplacés en parallèle vers la zone de leur bucket (un pointeur de lecture et un d'écriture atomiques par bucket).
+     * 4- Le nettoyage place les debuts et fins de bucket qui ne tombent pas sur un bloc et vide les buffers.
+     * 5- Les buckets sont triés en parallèle, les trop gros sont repassés au samplesort.
+     * La mémoire en plus est de l'ordre de threads * buckets * bloc, et non pas de la taille de la collection.
+     */
+    template <typename T, typename Compare>
+    class SampleSorter
+    {
+    public:
+        using BaseCase = void (*)(T *const, int const, Compare);
+
+        static void sort(T *const array, int const size, int threads, Compare comp, BaseCase baseCase, int depth = 0);
+
+    private:
+        T *const array;
+        int const size;
+        int const threads;
+        Compare comp;
+
+        int blockSize;
+        int levels;     // profondeur de l'arbre des splitters
+        int numBuckets; // 2^levels buckets + 2^levels - 1 buckets d'égalité
+        std::vector<T> splitters; // triés
+        std::vector<T> tree;      // mêmes splitters en ordre BFS, tree[0] inutilisé
+
+        // par thread
+        std::vector<int> stripeBlockBegin; // premier bloc de chaque bande, stripeBlockBegin[threads] = nombre de blocs pleins
+        std::vector<int> writeBlockEnd;    // fin des blocs pleins réécrits dans chaque bande
+        std::vector<std::vector<T>> buffers;
+        std::vector<std::vector<int>> bufferFill;
+        std::vector<std::vector<int>> blockCount;
+
+        // par bucket
+        std::vector<int> bucketStart;                // en elements, bucketStart[numBuckets] = size
+        std::vector<int> regionBegin;                // premier bloc de la zone du bucket
+        std::vector<int> bucketBlocks;               // nombre de blocs pleins du bucket
+        std::vector<std::atomic<uint64_t>> pointers; // (écriture << 32) | lecture, en blocs
+        std::vector<std::atomic<int>> reading;       // lectures de blocs en cours dans la zone du bucket
+
+        std::vector<T> overflow; // le dernier bloc peut dépasser la fin de la collection
+        bool overflowUsed;
+
+        SampleSorter(T *const array, int const size, int const threads, Compare comp);
+
+        void selectSplitters(BaseCase baseCase);
+        int bucketOf(T const &value) const;
+        void classifyStripe(int t);
+        void computeBuckets();
+        bool isFilled(int block) const;
+        void compactRegions(int t);
+        bool popBlock(int bucket, int &block);
+        bool claimSlot(int bucket, int &slot);
+        void permuteBlocks(int t);
+        void cleanup();
+        void sortBuckets(BaseCase baseCase, int depth);
+    };
+
+    template <typename T, typename Compare>
+    void SampleSorter<T, Compare>::sort(T *const array, int const size, int threads, Compare comp, BaseCase baseCase, int depth)
+    {
+        if (size < SAMPLESORT_MIN_SIZE || depth >= SAMPLESORT_MAX_DEPTH)
+        {
+            baseCase(array, size, comp);
+            return;
+        }
+
+        SampleSorter sorter(array, size, threads, comp);
+        sorter.selectSplitters(baseCase);
+        parallelFor(threads, [&](int t)
+                    { sorter.classifyStripe(t); });
+        sorter.computeBuckets();
+        parallelFor(threads, [&](int t)
+                    { sorter.compactRegions(t); });
+        parallelFor(threads, [&](int t)
+                    { sorter.permuteBlocks(t); });
+        sorter.cleanup();
+        sorter.sortBuckets(baseCase, depth);
+    }
+
+    template <typename T, typename Compare>
+    SampleSorter<T, Compare>::SampleSorter(T *const array, int const size, int const threads, Compare comp)
+        : array(array), size(size), threads(threads), comp(comp), overflowUsed(false)
+    {
+        blockSize = std::max<int>(1, SAMPLESORT_BLOCK_BYTES / sizeof(T));
+
+        // assez de blocs par bucket pour que le nettoyage reste négligeable
+        levels = 1;
+        while (levels < SAMPLESORT_MAX_LEVELS && (size >> (levels + 1)) >= SAMPLESORT_OVERSAMPLING * blockSize)
+            levels++;
+        numBuckets = (2 << levels) - 1;
+
+        int fullBlocks = size / blockSize;
+        stripeBlockBegin.resize(threads + 1);
+        for (int t = 0; t <= threads; t++)
+            stripeBlockBegin[t] = (long long)fullBlocks * t / threads;
+        writeBlockEnd.resize(threads);
+        buffers.resize(threads, std::vector<T>(numBuckets * blockSize));
+        bufferFill.resize(threads, std::vector<int>(numBuckets, 0));
+        blockCount.resize(threads, std::vector<int>(numBuckets, 0));
+
+        // les atomiques ne se copient pas, on ne peut pas faire de resize
+        std::vector<std::atomic<uint64_t>> bucketPointers(numBuckets);
+        pointers.swap(bucketPointers);
+        std::vector<std::atomic<int>> bucketReading(numBuckets);
+        reading.swap(bucketReading);
+        overflow.resize(blockSize);
+    }
+
+    /**
+     * Echantillon aléatoire (graine fixe pour avoir un tri reproductible), trié avec le tri de base.
+     */
+    template <typename T, typename Compare>
+    void SampleSorter<T, Compare>::selectSplitters(BaseCase baseCase)
+    {
+        int leaves = 1 << levels;
+        int sampleSize = leaves * SAMPLESORT_OVERSAMPLING;
+        std::mt19937 generator(size);
+        std::uniform_int_distribution<int> distribute(0, size - 1);
+
+        std::vector<T> sample;
+        sample.reserve(sampleSize);
+        for (int i = 0; i < sampleSize; i++)
+            sample.push_back(array[distribute(generator)]);
+        baseCase(&sample[0], sampleSize, comp);
+
+        splitters.clear();
+        for (int i = 1; i < leaves; i++)
+            splitters.push_back(sample[i * SAMPLESORT_OVERSAMPLING]);
+
+        // remplissage de l'arbre en parcours infixe: le noeud i a ses enfants en 2i et 2i + 1
+        tree.assign(leaves, splitters[0]);
+        int next = 0;
+        std::vector<int> stack;
+        int node = 1;
+        while (node < leaves || !stack.empty())
+        {
+            while (node < leaves)
+            {
+                stack.push_back(node);
+                node = 2 * node;
+            }
+            node = stack.back();
+            stack.pop_back();
+            tree[node] = splitters[next++];
+            node = 2 * node + 1;
+        }
+    }
+
+    /**
+     * b = nombre de splitters <= value, calculé sans branchement en descendant l'arbre.
+     * Bucket 2b pour ]splitters[b - 1], splitters[b][, bucket 2b - 1 pour les elements égaux à splitters[b - 1].
+     */
+    template <typename T, typename Compare>
+    inline int SampleSorter<T, Compare>::bucketOf(T const &value) const
+    {
+        int node = 1;
+        for (int l = 0; l < levels; l++)
+            node = 2 * node + !comp(value, tree[node]);
+        int b = node - (1 << levels);
+        return 2 * b - (b > 0 && !comp(splitters[b - 1], value));
+    }
+
+    template <typename T, typename Compare>
+    void SampleSorter<T, Compare>::classifyStripe(int t)
+    {
+        // la dernière bande prend aussi les elements aprés le dernier bloc plein
+        int begin = stripeBlockBegin[t] * blockSize;
+        int end = t == threads - 1 ? size : stripeBlockBegin[t + 1] * blockSize;
+
+        T *const buffer = &buffers[t][0];
+        int *const fill = &bufferFill[t][0];
+        int *const count = &blockCount[t][0];
+        int write = begin;
+        for (int i = begin; i < end; i++)
+        {
+            int b = bucketOf(array[i]);
+            MYCOLLECTION_CHECK_RANGE(b, 0, numBuckets);
+            buffer[b * blockSize + fill[b]++] = std::move(array[i]);
+            if (fill[b] == blockSize)
+            {
+                // on a lu au moins autant d'elements qu'on en a écrit plus ceux en buffer: la place est libre
+                std::move(buffer + b * blockSize, buffer + (b + 1) * blockSize, array + write);
+                write += blockSize;
+                fill[b] = 0;
+                count[b]++;
+            }
+        }
+        writeBlockEnd[t] = write / blockSize;
+    }
+
+    /**
+     * Taille et début de chaque bucket. La zone de blocs d'un bucket commence au premier bloc aligné dans le bucket,
+     * ses blocs pleins peuvent déborder sur le début (non aligné) du bucket suivant, jamais sur ses blocs.
+     */
+    template <typename T, typename Compare>
+    void SampleSorter<T, Compare>::computeBuckets()
+    {
+        bucketStart.assign(numBuckets + 1, 0);
+        regionBegin.assign(numBuckets + 1, 0);
+        bucketBlocks.assign(numBuckets, 0);
+        for (int b = 0; b < numBuckets; b++)
+        {
+            int total = 0;
+            for (int t = 0; t < threads; t++)
+            {
+                bucketBlocks[b] += blockCount[t][b];
+                total += blockCount[t][b] * blockSize + bufferFill[t][b];
+            }
+            bucketStart[b + 1] = bucketStart[b] + total;
+        }
+        for (int b = 0; b <= numBuckets; b++)
+            regionBegin[b] = (bucketStart[b] + blockSize - 1) / blockSize;
+    }
+
+    template <typename T, typename Compare>
+    bool SampleSorter<T, Compare>::isFilled(int block) const
+    {
+        if (block >= stripeBlockBegin[threads])
+            return false;
+        int t = std::upper_bound(stripeBlockBegin.begin(), stripeBlockBegin.end(), block) - stripeBlockBegin.begin() - 1;
+        return block < writeBlockEnd[t];
+    }
+
+    /**
+     * Dans la zone de chaque bucket on ramène les blocs pleins au début, la lecture pourra alors se faire de la fin vers le début.
+     */
+    template <typename T, typename Compare>
+    void SampleSorter<T, Compare>::compactRegions(int t)
+    {
+        for (int b = t; b < numBuckets; b += threads)
+        {
+            int filled = 0;
+            for (int block = regionBegin[b]; block < regionBegin[b + 1]; block++)
+                filled += isFilled(block);
+
+            // lo cherche les trous dans [regionBegin, regionBegin + filled), hi les blocs pleins aprés
+            int lo = regionBegin[b];
+            int hi = regionBegin[b] + filled;
+            while (true)
+            {
+                while (lo < regionBegin[b] + filled && isFilled(lo))
+                    lo++;
+                while (hi < regionBegin[b + 1] && !isFilled(hi))
+                    hi++;
+                if (lo >= regionBegin[b] + filled || hi >= regionBegin[b + 1])
+                    break;
+                std::move(array + hi * blockSize, array + (hi + 1) * blockSize, array + lo * blockSize);
+                lo++;
+                hi++;
+            }
+            pointers[b].store(((uint64_t)regionBegin[b] << 32) | (uint32_t)(regionBegin[b] + filled));
+            reading[b].store(0);
+        }
+    }
+
+    /**
+     * Retire le dernier bloc non traité de la zone du bucket. reading est incrémenté avant pour qu'un thread qui voudrait
+     * écrire à cette place attende la fin de la copie.
+     */
+    template <typename T, typename Compare>
+    bool SampleSorter<T, Compare>::popBlock(int bucket, int &block)
+    {
+        reading[bucket]++;
+        uint64_t current = pointers[bucket].load();
+        while (true)
+        {
+            uint32_t write = current >> 32;
+            uint32_t read = (uint32_t)current;
+            if (read <= write)
+            {
+                reading[bucket]--;
+                return false;
+            }
+            if (pointers[bucket].compare_exchange_weak(current, ((uint64_t)write << 32) | (read - 1)))
+            {
+                block = read - 1;
+                return true;
+            }
+        }
+    }
+
+    /**
+     * Réserve la prochaine place d'écriture du bucket.
+     * @return true si cette place contient encore un bloc non traité (il faut l'échanger), false si elle est libre
+     */
+    template <typename T, typename Compare>
+    bool SampleSorter<T, Compare>::claimSlot(int bucket, int &slot)
+    {
+        uint64_t current = pointers[bucket].fetch_add((uint64_t)1 << 32);
+        slot = current >> 32;
+        return (uint32_t)slot < (uint32_t)current;
+    }
+
+    template <typename T, typename Compare>
+    void SampleSorter<T, Compare>::permuteBlocks(int t)
+    {
+        std::vector<T> swapBuffers(2 * blockSize);
+        T *current = &swapBuffers[0];
+        T *other = &swapBuffers[blockSize];
+
+        int firstBucket = (long long)numBuckets * t / threads;
+        for (int i = 0; i < numBuckets; i++)
+        {
+            int b = (firstBucket + i) % numBuckets;
+            int block;
+            while (popBlock(b, block))
+            {
+                std::move(array + block * blockSize, array + (block + 1) * blockSize, current);
+                reading[b]--;
+
+                // on porte le bloc jusqu'à une place libre, en échangeant avec les blocs non traités rencontrés
+                int destination = bucketOf(current[0]);
+                int slot;
+                while (claimSlot(destination, slot))
+                {
+                    std::move(array + slot * blockSize, array + (slot + 1) * blockSize, other);
+                    std::move(current, current + blockSize, array + slot * blockSize);
+                    std::swap(current, other);
+                    destination = bucketOf(current[0]);
+                }
+                while (reading[destination].load() > 0)
+                    std::this_thread::yield();
+                if ((slot + 1) * blockSize > size)
+                {
+                    std::move(current, current + blockSize, &overflow[0]);
+                    overflowUsed = true;
+                }
+                else
+                    std::move(current, current + blockSize, array + slot * blockSize);
+            }
+        }
+    }
+
+    /**
+     * Pour chaque bucket dans l'ordre: les places libres sont le début non aligné du bucket (libéré par le bucket précédent)
+     * et la fin aprés ses blocs. On y met ce qui a débordé sur le bucket suivant puis le contenu des buffers.
+     */
+    template <typename T, typename Compare>
+    void SampleSorter<T, Compare>::cleanup()
+    {
+        int overflowBlock = size / blockSize;
+        for (int b = 0; b < numBuckets; b++)
+        {
+            int begin = bucketStart[b];
+            int end = bucketStart[b + 1];
+            int alignedBegin = regionBegin[b] * blockSize;
+            int written = alignedBegin + bucketBlocks[b] * blockSize;
+
+            if (overflowUsed && regionBegin[b] <= overflowBlock && overflowBlock < regionBegin[b] + bucketBlocks[b])
+                std::move(&overflow[0], &overflow[0] + (size - overflowBlock * blockSize), array + overflowBlock * blockSize);
+
+            int freePosition = begin;
+            int freeEnd = std::min(alignedBegin, end);
+            auto place = [&](T &value)
+            {
+                if (freePosition == freeEnd)
+                {
+                    freePosition = written;
+                    freeEnd = end;
+                }
+                MYCOLLECTION_CHECK_RANGE(freePosition, begin, end);
+                array[freePosition++] = std::move(value);
+            };
+
+            for (int p = std::max(end, alignedBegin); p < written; p++)
+                place(p >= size ? overflow[p - overflowBlock * blockSize] : array[p]);
+            for (int t = 0; t < threads; t++)
+                for (int i = 0; i < bufferFill[t][b]; i++)
+                    place(buffers[t][b * blockSize + i]);
+        }
+    }
+
+    /**
+     * Les buckets d'égalité (impairs) sont déja triés. Un bucket plus gros que ce que recevrait un thread repasse par le samplesort
+     * avec tous les threads, les autres sont distribués aux threads qui les trient avec le tri de base.
+     */
+    template <typename T, typename Compare>
+    void SampleSorter<T, Compare>::sortBuckets(BaseCase baseCase, int depth)
+    {
+        std::vector<int> smallBuckets;
+        for (int b = 0; b < numBuckets; b += 2)
+        {
+            int bucketSize = bucketStart[b + 1] - bucketStart[b];
+            if (threads > 1 && bucketSize > size / threads)
+                sort(array + bucketStart[b], bucketSize, threads, comp, baseCase, depth + 1);
+            else if (bucketSize > 1)
+                smallBuckets.push_back(b);
+        }
+
+        std::atomic<int> next(0);
+        parallelFor(threads, [&](int)
+                    {
+                        int i;
+                        while ((i = next++) < (int)smallBuckets.size())
+                        {
+                            int b = smallBuckets[i];
+                            int bucketSize = bucketStart[b + 1] - bucketStart[b];
+                            if (threads == 1)
+                                sort(array + bucketStart[b], bucketSize, 1, comp, baseCase, depth + 1);
+                            else
+                                baseCase(array + bucketStart[b], bucketSize, comp);
+                        } });
+    }
+}
@@ -0,0 +1,240 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+#include "SimdSort.hpp" // MYCOLLECTION_SIMD et les intrinsics
+
+namespace mycollections
+{
+    /**
+     * Le premier index i de [0, size) tel que before(array[i]) est faux, array étant partitionné (before vrai puis faux).
+     * Recherche binaire sans branchement: la taille de l'intervalle ne dépend que de size, à chaque niveau base avance ou pas
+     * selon une comparaison compilée en cmov. Pas de mauvaise prédiction de branchement, la boucle fait toujours ceil(log2(size)) tours.
+     */
+    template <typename T, typename Before>
+    int partitionPoint(T const *const array, int const size, Before before)
+    {
+        if (size == 0)
+            return 0;
+        T const *base = array;
+        int length = size;
+        while (length > 1)
+        {
+            int const half = length / 2;
+#if defined(__GNUC__)
+            // les deux éléments possibles du niveau suivant, chargés pendant la comparaison de celui-ci
+            __builtin_prefetch(base + half / 2);
+            __builtin_prefetch(base + half + half / 2);
+#endif
+            base = before(base[half - 1]) ? base + half : base;
+            length -= half;
+        }
+        return (base - array) + before(*base);
+    }
+
+    // premier element qui ne passe pas avant value (std::lower_bound)
+    template <typename T, typename Compare>
+    int lowerBound(T const *const array, int const size, T const &value, Compare comp)
+    {
+        return partitionPoint(array, size, [&value, &comp](T const &element)
+                              { return comp(element, value); });
+    }
+
+    // premier element qui passe aprés value (std::upper_bound)
+    template <typename T, typename Compare>
+    int upperBound(T const *const array, int const size, T const &value, Compare comp)
+    {
+        return partitionPoint(array, size, [&value, &comp](T const &element)
+                              { return !comp(value, element); });
+    }
+
+    // nombre de recherches menées de front par lowerBoundBatch
+    const int SEARCH_BATCH_WIDTH = 16;
+
+    /**
+     * lowerBound de count clés, SEARCH_BATCH_WIDTH recherches à la fois: toutes les recherches d'un groupe ont la même longueur
+     * d'intervalle à chaque niveau (elle ne dépend que de size), elles avancent donc ensemble d'un niveau par tour.
+     * Les chargements d'un niveau sont indépendants entre eux: leurs défauts de cache se recouvrent au lieu de s'attendre,
+     * et le niveau suivant de chaque recherche est préchargé pendant que les autres comparent.
+     */
+    template <typename T, typename Compare>
+    void lowerBoundBatch(T const *const array, int const size, T const *const keys, std::size_t const count, int64_t *const out, Compare comp)
+    {
+        T const *bases[SEARCH_BATCH_WIDTH];
+        for (std::size_t first = 0; first < count; first += SEARCH_BATCH_WIDTH)
+        {
+            int const width = std::min<std::size_t>(SEARCH_BATCH_WIDTH, count - first);
+            T const *const group = keys + first;
+            if (size == 0)
+            {
+                for (int j = 0; j < width; j++)
+                    out[first + j] = 0;
+                continue;
+            }
+            for (int j = 0; j < width; j++)
+                bases[j] = array;
+            for (int length = size; length > 1;)
+            {
+                int const half = length / 2;
+                for (int j = 0; j < width; j++)
+                {
+#if defined(__GNUC__)
+                    __builtin_prefetch(bases[j] + half / 2);
+                    __builtin_prefetch(bases[j] + half + half / 2);
+#endif
+                    bases[j] = comp(bases[j][half - 1], group[j]) ? bases[j] + half : bases[j];
+                }
+                length -= half;
+            }
+            for (int j = 0; j < width; j++)
+                out[first + j] = (bases[j] - array) + comp(*bases[j], group[j]);
+        }
+    }
+
+    /**
+     * Index du premier element égal à value (==), -1 s'il n'y en a pas.
+     */
+    template <typename T>
+    int linearSearch(T const *const array, int const size, T const &value)
+    {
+        for (int i = 0; i < size; i++)
+            if (array[i] == value)
+                return i;
+        return -1;
+    }
+
+    // nombre d'elements < value et > value de array[0, size): sans branchement, array trié ou pas (fin de recherche de LearnedIndex).
+    // Boucle que le compilateur peut vectoriser, version SIMD explicite pour les int32 et u32
+    template <typename T>
+    int countLess(T const *const array, int const size, T const &value)
+    {
+        int count = 0;
+        for (int i = 0; i < size; i++)
+            count += array[i] < value;
+        return count;
+    }
+
+    template <typename T>
+    int countGreater(T const *const array, int const size, T const &value)
+    {
+        int count = 0;
+        for (int i = 0; i < size; i++)
+            count += value < array[i];
+        return count;
+    }
+
+#ifdef MYCOLLECTION_SIMD
+    /**
+     * Comptage SIMD pour les entiers de 32 bits: les masques des comparaisons (-1 par voie vraie) sont soustraits à un accumulateur.
+     * flip est appliqué aux deux côtés avant la comparaison signée (bit de signe pour des uint32), greater compte les elements > value, sinon < value.
+     */
+    inline int countCompared(int32_t const *const array, int const size, int32_t value, int32_t const flip, bool const greater)
+    {
+        value ^= flip;
+        int i = 0, count = 0;
+#ifdef __AVX2__
+        __m256i const needle = _mm256_set1_epi32(value), flips = _mm256_set1_epi32(flip);
+        __m256i counts = _mm256_setzero_si256();
+        for (; i + 8 <= size; i += 8)
+        {
+            __m256i const element = _mm256_xor_si256(_mm256_loadu_si256((__m256i const *)(array + i)), flips);
+            counts = _mm256_sub_epi32(counts, greater ? _mm256_cmpgt_epi32(element, needle) : _mm256_cmpgt_epi32(needle, element));
+        }
+        int32_t lanes[8];
+        _mm256_storeu_si256((__m256i *)lanes, counts);
+        for (int lane = 0; lane < 8; lane++)
+            count += lanes[lane];
+#else
+        __m128i const needle = _mm_set1_epi32(value), flips = _mm_set1_epi32(flip);
+        __m128i counts = _mm_setzero_si128();
+        for (; i + 4 <= size; i += 4)
+        {
+            __m128i const element = _mm_xor_si128(_mm_loadu_si128((__m128i const *)(array + i)), flips);
+            counts = _mm_sub_epi32(counts, greater ? _mm_cmpgt_epi32(element, needle) : _mm_cmpgt_epi32(needle, element));
+        }
+        int32_t lanes[4];
+        _mm_storeu_si128((__m128i *)lanes, counts);
+        for (int lane = 0; lane < 4; lane++)
+            count += lanes[lane];
+#endif
+        for (; i < size; i++)
+            count += greater ? (array[i] ^ flip) > value : (array[i] ^ flip) < value;
+        return count;
+    }
+
+    inline int countLess(int32_t const *const array, int const size, int32_t const &value) { return countCompared(array, size, value, 0, false); }
+    inline int countGreater(int32_t const *const array, int const size, int32_t const &value) { return countCompared(array, size, value, 0, true); }
+    inline int countLess(uint32_t const *const array, int const size, uint32_t const &value) { return countCompared((int32_t const *)array, size, value, INT32_MIN, false); }
+    inline int countGreater(uint32_t const *const array, int const size, uint32_t const &value) { return countCompared((int32_t const *)array, size, value, INT32_MIN, true); }
+
+    /**
+     * Parcours SIMD: 4 registres comparés à value par tour, un seul test sur l'union des masques.
+     * Quand un tour trouve quelque chose, la fin est faite en scalaire à partir du début de ce tour (le premier egal est donc bien le premier).
+     */
+    inline int linearSearch(int32_t const *const array, int const size, int32_t const &value)
+    {
+        int i = 0;
+#ifdef __AVX2__
+        __m256i const needle = _mm256_set1_epi32(value);
+        for (; i + 32 <= size; i += 32)
+        {
+            __m256i const *block = (__m256i const *)(array + i);
+            __m256i found = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi32(_mm256_loadu_si256(block), needle), _mm256_cmpeq_epi32(_mm256_loadu_si256(block + 1), needle)),
+                                            _mm256_or_si256(_mm256_cmpeq_epi32(_mm256_loadu_si256(block + 2), needle), _mm256_cmpeq_epi32(_mm256_loadu_si256(block + 3), needle)));
+            if (_mm256_movemask_epi8(found) != 0)
+                break;
+        }
+#else
+        __m128i const needle = _mm_set1_epi32(value);
+        for (; i + 16 <= size; i += 16)
+        {
+            __m128i const *block = (__m128i const *)(array + i);
+            __m128i found = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi32(_mm_loadu_si128(block), needle), _mm_cmpeq_epi32(_mm_loadu_si128(block + 1), needle)),
+                                         _mm_or_si128(_mm_cmpeq_epi32(_mm_loadu_si128(block + 2), needle), _mm_cmpeq_epi32(_mm_loadu_si128(block + 3), needle)));
+            if (_mm_movemask_epi8(found) != 0)
+                break;
+        }
+#endif
+        for (; i < size; i++)
+            if (array[i] == value)
+                return i;
+        return -1;
+    }
+
+    inline int linearSearch(uint32_t const *const array, int const size, uint32_t const &value)
+    {
+        return linearSearch((int32_t const *)array, size, (int32_t)value);
+    }
+
+    // comparaison de float (et non de bits): -0.0 == +0.0 et un NaN n'est jamais trouvé, comme avec ==
+    inline int linearSearch(float const *const array, int const size, float const &value)
+    {
+        int i = 0;
+#ifdef __AVX2__
+        __m256 const needle = _mm256_set1_ps(value);
+        for (; i + 32 <= size; i += 32)
+        {
+            float const *block = array + i;
+            __m256 found = _mm256_or_ps(_mm256_or_ps(_mm256_cmp_ps(_mm256_loadu_ps(block), needle, _CMP_EQ_OQ), _mm256_cmp_ps(_mm256_loadu_ps(block + 8), needle, _CMP_EQ_OQ)),
+                                        _mm256_or_ps(_mm256_cmp_ps(_mm256_loadu_ps(block + 16), needle, _CMP_EQ_OQ), _mm256_cmp_ps(_mm256_loadu_ps(block + 24), needle, _CMP_EQ_OQ)));
+            if (_mm256_movemask_ps(found) != 0)
+                break;
+        }
+#else
+        __m128 const needle = _mm_set1_ps(value);
+        for (; i + 16 <= size; i += 16)
+        {
+            float const *block = array + i;
+            __m128 found = _mm_or_ps(_mm_or_ps(_mm_cmpeq_ps(_mm_loadu_ps(block), needle), _mm_cmpeq_ps(_mm_loadu_ps(block + 4), needle)),
+                                     _mm_or_ps(_mm_cmpeq_ps(_mm_loadu_ps(block + 8), needle), _mm_cmpeq_ps(_mm_loadu_ps(block + 12), needle)));
+            if (_mm_movemask_ps(found) != 0)
+                break;
+        }
+#endif
+        for (; i < size; i++)
+            if (array[i] == value)
+                return i;
+        return -1;
+    }
+#endif
+}
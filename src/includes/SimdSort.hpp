@@ -0,0 +1,416 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <utility>
+#include <functional>
+#include <type_traits>
+#include "Ordering.hpp"
+
+// SSE2 fait partie de x86-64, AVX2 seulement avec -mavx2 ou -march=native (option MYCOLLECTION_NATIVE de CMakeLists.txt)
+#if defined(__SSE2__) && !defined(MYCOLLECTION_NO_SIMD)
+#define MYCOLLECTION_SIMD
+#include <immintrin.h>
+#endif
+
+namespace mycollections
+{
+    // taille des cas de base triés par réseau de tri dans les registres
+    const int SIMD_SORT_BLOCK = 64;
+
+    /**
+     * Les noyaux SIMD de tri et de merge pour un type et un comparateur.
+     * Par défaut rien n'est vectorisé (enabled = false): les tris gardent leur insertion sort et leur merge scalaire.
+     */
+    template <typename T, typename Compare, typename Enable = void>
+    struct SimdSort
+    {
+        static const bool enabled = false;
+
+        static void sortBlock(T *const, int const) {}
+        static bool merge(T const *const, int const, T const *const, int const, T *const, Compare) { return false; }
+    };
+
+#ifdef MYCOLLECTION_SIMD
+    /**
+     * Les types de 32 bits triés en SIMD: chaque valeur est transformée en un int32 dont l'ordre signé est celui de la valeur,
+     * la transformation est une bijection qui est défaite au moment de l'écriture (les valeurs écrites sont exactement celles lues).
+     *  - int32: rien, uint32: bit de signe inversé
+     *  - float: les bits d'un négatif sont inversés sauf le signe, -0.0 est placé avant +0.0 et les NaN aux extrémités
+     */
+    template <typename T>
+    struct SimdKey
+    {
+        static const bool sortable = false;
+    };
+
+    template <>
+    struct SimdKey<int32_t>
+    {
+        static const bool sortable = true;
+        static const bool floating = false;
+        static const int32_t flip = 0;
+    };
+
+    template <>
+    struct SimdKey<uint32_t>
+    {
+        static const bool sortable = true;
+        static const bool floating = false;
+        static const int32_t flip = INT32_MIN;
+    };
+
+    template <>
+    struct SimdKey<float>
+    {
+        static const bool sortable = true;
+        static const bool floating = true;
+        static const int32_t flip = 0;
+    };
+
+    /**
+     * 4 int32 par registre (SSE2, min et max en SSE4.1 si disponible).
+     */
+    struct SseLanes
+    {
+        using Vector = __m128i;
+        static const int LANES = 4;
+
+        static Vector load(int32_t const *const p) { return _mm_loadu_si128((__m128i const *)p); }
+        static void store(int32_t *const p, Vector const v) { _mm_storeu_si128((__m128i *)p, v); }
+        static Vector set1(int32_t const x) { return _mm_set1_epi32(x); }
+        static Vector iota() { return _mm_setr_epi32(0, 1, 2, 3); }
+        static Vector add(Vector const a, Vector const b) { return _mm_add_epi32(a, b); }
+        static Vector bitXor(Vector const a, Vector const b) { return _mm_xor_si128(a, b); }
+        // les bits d'un float négatif hors signe: 0x7FFFFFFF si v < 0, 0 sinon
+        static Vector negativeMask(Vector const v) { return _mm_srli_epi32(_mm_srai_epi32(v, 31), 1); }
+        static Vector lessThan(Vector const a, Vector const b) { return _mm_cmplt_epi32(a, b); }
+        // mask ? a : b
+        static Vector select(Vector const mask, Vector const a, Vector const b) { return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b)); }
+
+        static void minMax(Vector &a, Vector &b)
+        {
+#ifdef __SSE4_1__
+            Vector low = _mm_min_epi32(a, b);
+            b = _mm_max_epi32(a, b);
+            a = low;
+#else
+            Vector greater = _mm_cmpgt_epi32(a, b);
+            Vector low = select(greater, b, a);
+            b = select(greater, a, b);
+            a = low;
+#endif
+        }
+
+        static Vector reverse(Vector const v) { return _mm_shuffle_epi32(v, _MM_SHUFFLE(0, 1, 2, 3)); }
+
+        // trie une séquence bitonique dans un registre: comparaisons à distance 2 puis 1
+        static Vector cleanBitonic(Vector v)
+        {
+            Vector swapped = _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2));
+            Vector low = v;
+            minMax(low, swapped);
+            v = select(_mm_setr_epi32(0, 0, -1, -1), swapped, low);
+            swapped = _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1));
+            low = v;
+            minMax(low, swapped);
+            return select(_mm_setr_epi32(0, -1, 0, -1), swapped, low);
+        }
+
+        // réseau optimal à 4 entrées (5 comparateurs) sur les colonnes de 4 registres
+        static void sortColumns(Vector *const v)
+        {
+            minMax(v[0], v[1]);
+            minMax(v[2], v[3]);
+            minMax(v[0], v[2]);
+            minMax(v[1], v[3]);
+            minMax(v[1], v[2]);
+        }
+
+        static void transpose(Vector *const v)
+        {
+            Vector t0 = _mm_unpacklo_epi32(v[0], v[1]), t1 = _mm_unpackhi_epi32(v[0], v[1]);
+            Vector t2 = _mm_unpacklo_epi32(v[2], v[3]), t3 = _mm_unpackhi_epi32(v[2], v[3]);
+            v[0] = _mm_unpacklo_epi64(t0, t2);
+            v[1] = _mm_unpackhi_epi64(t0, t2);
+            v[2] = _mm_unpacklo_epi64(t1, t3);
+            v[3] = _mm_unpackhi_epi64(t1, t3);
+        }
+    };
+
+#ifdef __AVX2__
+    /**
+     * 8 int32 par registre.
+     */
+    struct Avx2Lanes
+    {
+        using Vector = __m256i;
+        static const int LANES = 8;
+
+        static Vector load(int32_t const *const p) { return _mm256_loadu_si256((__m256i const *)p); }
+        static void store(int32_t *const p, Vector const v) { _mm256_storeu_si256((__m256i *)p, v); }
+        static Vector set1(int32_t const x) { return _mm256_set1_epi32(x); }
+        static Vector iota() { return _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7); }
+        static Vector add(Vector const a, Vector const b) { return _mm256_add_epi32(a, b); }
+        static Vector bitXor(Vector const a, Vector const b) { return _mm256_xor_si256(a, b); }
+        static Vector negativeMask(Vector const v) { return _mm256_srli_epi32(_mm256_srai_epi32(v, 31), 1); }
+        static Vector lessThan(Vector const a, Vector const b) { return _mm256_cmpgt_epi32(b, a); }
+        static Vector select(Vector const mask, Vector const a, Vector const b) { return _mm256_blendv_epi8(b, a, mask); }
+
+        static void minMax(Vector &a, Vector &b)
+        {
+            Vector low = _mm256_min_epi32(a, b);
+            b = _mm256_max_epi32(a, b);
+            a = low;
+        }
+
+        static Vector reverse(Vector const v) { return _mm256_permutevar8x32_epi32(v, _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0)); }
+
+        // comparaisons à distance 4 (les deux moitiés de 128 bits), 2 puis 1
+        static Vector cleanBitonic(Vector v)
+        {
+            Vector swapped = _mm256_permute2x128_si256(v, v, 1);
+            Vector low = v;
+            minMax(low, swapped);
+            v = _mm256_blend_epi32(low, swapped, 0xF0);
+            swapped = _mm256_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2));
+            low = v;
+            minMax(low, swapped);
+            v = _mm256_blend_epi32(low, swapped, 0xCC);
+            swapped = _mm256_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1));
+            low = v;
+            minMax(low, swapped);
+            return _mm256_blend_epi32(low, swapped, 0xAA);
+        }
+
+        // réseau optimal à 8 entrées (19 comparateurs) sur les colonnes de 8 registres
+        static void sortColumns(Vector *const v)
+        {
+            minMax(v[0], v[2]);
+            minMax(v[1], v[3]);
+            minMax(v[4], v[6]);
+            minMax(v[5], v[7]);
+            minMax(v[0], v[4]);
+            minMax(v[1], v[5]);
+            minMax(v[2], v[6]);
+            minMax(v[3], v[7]);
+            minMax(v[0], v[1]);
+            minMax(v[2], v[3]);
+            minMax(v[4], v[5]);
+            minMax(v[6], v[7]);
+            minMax(v[2], v[4]);
+            minMax(v[3], v[5]);
+            minMax(v[1], v[4]);
+            minMax(v[3], v[6]);
+            minMax(v[1], v[2]);
+            minMax(v[3], v[4]);
+            minMax(v[5], v[6]);
+        }
+
+        static void transpose(Vector *const v)
+        {
+            Vector t0 = _mm256_unpacklo_epi32(v[0], v[1]), t1 = _mm256_unpackhi_epi32(v[0], v[1]);
+            Vector t2 = _mm256_unpacklo_epi32(v[2], v[3]), t3 = _mm256_unpackhi_epi32(v[2], v[3]);
+            Vector t4 = _mm256_unpacklo_epi32(v[4], v[5]), t5 = _mm256_unpackhi_epi32(v[4], v[5]);
+            Vector t6 = _mm256_unpacklo_epi32(v[6], v[7]), t7 = _mm256_unpackhi_epi32(v[6], v[7]);
+            Vector u0 = _mm256_unpacklo_epi64(t0, t2), u1 = _mm256_unpackhi_epi64(t0, t2);
+            Vector u2 = _mm256_unpacklo_epi64(t1, t3), u3 = _mm256_unpackhi_epi64(t1, t3);
+            Vector u4 = _mm256_unpacklo_epi64(t4, t6), u5 = _mm256_unpackhi_epi64(t4, t6);
+            Vector u6 = _mm256_unpacklo_epi64(t5, t7), u7 = _mm256_unpackhi_epi64(t5, t7);
+            v[0] = _mm256_permute2x128_si256(u0, u4, 0x20);
+            v[1] = _mm256_permute2x128_si256(u1, u5, 0x20);
+            v[2] = _mm256_permute2x128_si256(u2, u6, 0x20);
+            v[3] = _mm256_permute2x128_si256(u3, u7, 0x20);
+            v[4] = _mm256_permute2x128_si256(u0, u4, 0x31);
+            v[5] = _mm256_permute2x128_si256(u1, u5, 0x31);
+            v[6] = _mm256_permute2x128_si256(u2, u6, 0x31);
+            v[7] = _mm256_permute2x128_si256(u3, u7, 0x31);
+        }
+    };
+
+    using SimdLanes = Avx2Lanes;
+#else
+    using SimdLanes = SseLanes;
+#endif
+
+    /**
+     * Merge bitonique de v[0, count / 2) et v[count / 2, count), deux suites triées de registres:
+     * la deuxième est retournée pour que l'ensemble soit bitonique, puis comparaisons à distance count / 2, ..., 1 registres
+     * et enfin dans chaque registre. Aucun branchement qui dépend des données.
+     */
+    template <typename Lanes>
+    void mergeVectors(typename Lanes::Vector *const v, int const count)
+    {
+        int const half = count / 2;
+        for (int i = 0; i < half / 2; i++)
+            std::swap(v[half + i], v[count - 1 - i]);
+        for (int i = half; i < count; i++)
+            v[i] = Lanes::reverse(v[i]);
+        for (int distance = half; distance >= 1; distance /= 2)
+            for (int i = 0; i < count; i++)
+                if (!(i & distance))
+                    Lanes::minMax(v[i], v[i + distance]);
+        for (int i = 0; i < count; i++)
+            v[i] = Lanes::cleanBitonic(v[i]);
+    }
+
+    /**
+     * Trie Count registres (Count * LANES int32): chaque groupe de LANES registres passe par le réseau de tri sur ses colonnes
+     * puis est transposé (chaque registre devient une suite triée), ensuite les suites sont mergées deux à deux.
+     */
+    template <typename Lanes, int Count>
+    void sortVectors(typename Lanes::Vector *const v)
+    {
+        for (int group = 0; group < Count; group += Lanes::LANES)
+        {
+            Lanes::sortColumns(v + group);
+            Lanes::transpose(v + group);
+        }
+        for (int width = 2; width <= Count; width *= 2)
+            for (int group = 0; group < Count; group += width)
+                mergeVectors<Lanes>(v + group, width);
+    }
+
+    /**
+     * Tri SIMD pour T de 32 bits avec std::less/Less (ou std::greater/Greater: la clé est aussi inversée, ~x).
+     * sortBlock remplace l'insertion sort des cas de base, merge remplace la boucle scalaire de mergeRuns.
+     */
+    template <typename T, typename Compare>
+    struct SimdSort<T, Compare, typename std::enable_if<SimdKey<T>::sortable && NaturalOrder<T, Compare>::value != 0>::type>
+    {
+        static const bool enabled = true;
+
+        /**
+         * Trie size <= SIMD_SORT_BLOCK elements: copiés dans un bloc aligné, complétés par INT32_MAX (qui reste à la fin),
+         * triés dans les registres puis recopiés. 16 ou 32 elements en SSE, 64 avec les registres les plus larges.
+         */
+        static void sortBlock(T *const array, int const size)
+        {
+            alignas(32) int32_t keys[SIMD_SORT_BLOCK];
+            std::memcpy(keys, array, size * sizeof(T));
+            std::fill(keys + size, keys + SIMD_SORT_BLOCK, 0);
+            if (size <= 4 * SseLanes::LANES)
+                sortKeys<SseLanes, 4>(keys, size);
+            else if (size <= 8 * SseLanes::LANES)
+                sortKeys<SseLanes, 8>(keys, size);
+            else
+                sortKeys<SimdLanes, SIMD_SORT_BLOCK / SimdLanes::LANES>(keys, size);
+            std::memcpy(array, keys, size * sizeof(T));
+        }
+
+        /**
+         * Merge de deux runs triés dans out, un registre à la fois: le registre high garde les LANES plus grands elements lus,
+         * on charge le bloc suivant du run dont la tête est la plus petite, le merge bitonique (bloc, high) écrit sa moitié basse.
+         * Quand le run choisi n'a plus de bloc entier, high et les restes des deux runs sont mergés en scalaire.
+         * @return false si un des runs est plus court qu'un registre (le merge scalaire est alors fait par l'appelant)
+         */
+        static bool merge(T const *const left, int const leftSize, T const *const right, int const rightSize, T *const out, Compare comp)
+        {
+            using Lanes = SimdLanes;
+            using Vector = typename Lanes::Vector;
+            int const lanes = Lanes::LANES;
+            if (leftSize < lanes || rightSize < lanes)
+                return false;
+
+            Vector low = encode<Lanes>(Lanes::load((int32_t const *)left));
+            Vector high = encode<Lanes>(Lanes::load((int32_t const *)right));
+            int leftIndex = lanes, rightIndex = lanes, outIndex = 0;
+            while (true)
+            {
+                Vector pair[2] = {low, high};
+                mergeVectors<Lanes>(pair, 2);
+                Lanes::store((int32_t *)(out + outIndex), decode<Lanes>(pair[0]));
+                outIndex += lanes;
+                high = pair[1];
+
+                bool takeLeft = leftIndex < leftSize && (rightIndex == rightSize || key(left[leftIndex]) <= key(right[rightIndex]));
+                if (takeLeft && leftIndex + lanes <= leftSize)
+                {
+                    low = encode<Lanes>(Lanes::load((int32_t const *)(left + leftIndex)));
+                    leftIndex += lanes;
+                }
+                else if (!takeLeft && rightIndex + lanes <= rightSize)
+                {
+                    low = encode<Lanes>(Lanes::load((int32_t const *)(right + rightIndex)));
+                    rightIndex += lanes;
+                }
+                else
+                    break;
+            }
+
+            T rest[Lanes::LANES];
+            Lanes::store((int32_t *)rest, decode<Lanes>(high));
+            int restIndex = 0;
+            while (restIndex < lanes || leftIndex < leftSize || rightIndex < rightSize)
+            {
+                T const *next = restIndex < lanes ? &rest[restIndex] : nullptr;
+                int from = 0;
+                if (leftIndex < leftSize && (next == nullptr || comp(left[leftIndex], *next)))
+                {
+                    next = &left[leftIndex];
+                    from = 1;
+                }
+                if (rightIndex < rightSize && (next == nullptr || comp(right[rightIndex], *next)))
+                {
+                    next = &right[rightIndex];
+                    from = 2;
+                }
+                out[outIndex++] = *next;
+                if (from == 0)
+                    restIndex++;
+                else if (from == 1)
+                    leftIndex++;
+                else
+                    rightIndex++;
+            }
+            return true;
+        }
+
+    private:
+        // la clé int32 d'une valeur: transformation du type puis inversion de tous les bits pour un ordre décroissant
+        static const int32_t flip = SimdKey<T>::flip ^ (NaturalOrder<T, Compare>::value < 0 ? -1 : 0);
+
+        static int32_t key(T const value)
+        {
+            int32_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            if (SimdKey<T>::floating)
+                bits ^= (int32_t)((uint32_t)(bits >> 31) >> 1);
+            return bits ^ flip;
+        }
+
+        template <typename Lanes>
+        static typename Lanes::Vector encode(typename Lanes::Vector v)
+        {
+            if (SimdKey<T>::floating)
+                v = Lanes::bitXor(v, Lanes::negativeMask(v));
+            return Lanes::bitXor(v, Lanes::set1(flip));
+        }
+
+        // le signe n'est pas touché par la transformation des float: elle est sa propre inverse
+        template <typename Lanes>
+        static typename Lanes::Vector decode(typename Lanes::Vector v)
+        {
+            v = Lanes::bitXor(v, Lanes::set1(flip));
+            if (SimdKey<T>::floating)
+                v = Lanes::bitXor(v, Lanes::negativeMask(v));
+            return v;
+        }
+
+        template <typename Lanes, int Count>
+        static void sortKeys(int32_t *const keys, int const size)
+        {
+            typename Lanes::Vector v[Count];
+            typename Lanes::Vector const padding = Lanes::set1(INT32_MAX), limit = Lanes::set1(size);
+            for (int i = 0; i < Count; i++)
+            {
+                typename Lanes::Vector index = Lanes::add(Lanes::iota(), Lanes::set1(i * Lanes::LANES));
+                v[i] = Lanes::select(Lanes::lessThan(index, limit), encode<Lanes>(Lanes::load(keys + i * Lanes::LANES)), padding);
+            }
+            sortVectors<Lanes, Count>(v);
+            for (int i = 0; i < Count; i++)
+                Lanes::store(keys + i * Lanes::LANES, decode<Lanes>(v[i]));
+        }
+    };
+#endif
+}
@@ -0,0 +1,197 @@
+#pragma once
+#include <vector>
+#include <chrono>
+#include <limits>
+#include <random>
+#include <iostream>
+#include "SortConfig.hpp"
+#include "MyCollection.hpp"
+
+namespace mycollections
+{
+    // nombre d'elements triés pour chaque mesure (en morceaux de la taille mesurée)
+    const int SORT_CALIBRATION_SIZE = 1 << 16;
+    // plus grande taille essayée pour le seuil des tris parallèles
+    const int SORT_CALIBRATION_MAX_PARALLEL = 1 << 21;
+    // chaque mesure garde le meilleur temps sur ce nombre de passages
+    const int SORT_CALIBRATION_REPEATS = 3;
+
+    /**
+     * La calibration de sort(): chaque seuil est la taille à partir de laquelle un tri devient plus rapide qu'un autre sur cette machine,
+     * mesurée une fois sur des données aléatoires (graine fixe) avec les mêmes fonctions que celles appelées par sort().
+     * Friend de MyCollection pour mesurer insertionSortRange et blockQuickSortLoop sans passer par une collection.
+     */
+    class SortCalibration
+    {
+    public:
+        static SortConfig run()
+        {
+            SortConfig config;
+            config.threads = SortConfig::hostThreads();
+            config.optimized = SortConfig::hostOptimized();
+            config.smallSize = smallSize();
+            config.adaptiveRunLength = adaptiveRunLength();
+            config.radixMinSize32 = radixMinSize<uint32_t>();
+            config.radixMinSize64 = radixMinSize<uint64_t>();
+            config.parallelMinSize = parallelMinSize();
+            config.radixParallelMinSize = radixParallelMinSize();
+            return config;
+        }
+
+    private:
+        template <typename T>
+        static std::vector<T> randomKeys(int const size)
+        {
+            engine generator(size);
+            std::uniform_int_distribution<T> distribute;
+            std::vector<T> keys(size);
+            for (int i = 0; i < size; i++)
+                keys[i] = distribute(generator);
+            return keys;
+        }
+
+        // meilleur temps (secondes) de sortChunk sur tous les morceaux de chunk elements d'une copie de data
+        template <typename T, typename SortChunk>
+        static double timeChunks(std::vector<T> const &data, int const chunk, SortChunk sortChunk)
+        {
+            double best = std::numeric_limits<double>::max();
+            std::vector<T> work;
+            for (int r = 0; r < SORT_CALIBRATION_REPEATS; r++)
+            {
+                work = data;
+                auto start = std::chrono::steady_clock::now();
+                for (int offset = 0; offset + chunk <= (int)work.size(); offset += chunk)
+                    sortChunk(&work[offset], chunk);
+                std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+                best = std::min(best, elapsed.count());
+            }
+            return best;
+        }
+
+        template <typename T>
+        static double timeBlockQuickSort(std::vector<T> const &data, int const chunk)
+        {
+            return timeChunks(data, chunk, [](T *array, int size)
+                              { MyCollection<T>::blockQuickSortLoop(array, size, std::less<T>()); });
+        }
+
+        // plus grande taille où insertionSort bat encore blockQuickSort
+        static int smallSize()
+        {
+            std::vector<uint32_t> data = randomKeys<uint32_t>(SORT_CALIBRATION_SIZE / 4);
+            int best = SMALL_RANGE_CUTOFF;
+            for (int chunk = 2 * SMALL_RANGE_CUTOFF; chunk <= 256; chunk *= 2)
+            {
+                double insertion = timeChunks(data, chunk, [](uint32_t *array, int size)
+                                              { MyCollection<uint32_t>::insertionSortRange(array, 0, size, std::less<uint32_t>()); });
+                if (insertion > timeBlockQuickSort(data, chunk))
+                    break;
+                best = chunk;
+            }
+            return best;
+        }
+
+        // plus petite longueur moyenne de runs à partir de laquelle timSort bat blockQuickSort
+        static int adaptiveRunLength()
+        {
+            std::vector<uint32_t> data = randomKeys<uint32_t>(SORT_CALIBRATION_SIZE);
+            for (int run = 8; run < SORT_CALIBRATION_SIZE; run *= 2)
+            {
+                std::vector<uint32_t> runs(data);
+                for (int start = 0; start < SORT_CALIBRATION_SIZE; start += run)
+                    std::sort(runs.begin() + start, runs.begin() + std::min(start + run, SORT_CALIBRATION_SIZE));
+                double adaptive = timeChunks(runs, SORT_CALIBRATION_SIZE, [](uint32_t *array, int size)
+                                             { TimSorter<uint32_t, std::less<uint32_t>>::sort(array, size, std::less<uint32_t>()); });
+                if (adaptive < timeBlockQuickSort(runs, SORT_CALIBRATION_SIZE))
+                    return run;
+            }
+            return std::numeric_limits<int>::max();
+        }
+
+        // plus petite taille à partir de laquelle radixSort bat blockQuickSort pour des clés de sizeof(T) octets
+        template <typename T>
+        static int radixMinSize()
+        {
+            std::vector<T> data = randomKeys<T>(SORT_CALIBRATION_SIZE);
+            std::vector<T> buffer(SORT_CALIBRATION_SIZE);
+            for (int chunk = 64; chunk <= SORT_CALIBRATION_SIZE; chunk *= 2)
+            {
+                double radix = timeChunks(data, chunk, [&buffer](T *array, int size)
+                                          { radixSortLSD(array, &buffer[0], size, false); });
+                if (radix < timeBlockQuickSort(data, chunk))
+                    return chunk;
+            }
+            return std::numeric_limits<int>::max();
+        }
+
+        // plus petite taille à partir de laquelle sampleSort sur tous les coeurs bat blockQuickSort, jamais sur une machine à un coeur.
+        // En dessous de SAMPLESORT_MIN_SIZE sampleSort n'est que blockQuickSort: les mesures commencent là
+        static int parallelMinSize()
+        {
+            if (SortConfig::hostThreads() <= 1)
+                return std::numeric_limits<int>::max();
+            for (int size = SAMPLESORT_MIN_SIZE; size <= SORT_CALIBRATION_MAX_PARALLEL; size *= 2)
+            {
+                std::vector<uint32_t> data = randomKeys<uint32_t>(size);
+                double parallel = timeChunks(data, size, [](uint32_t *array, int length)
+                                             { SampleSorter<uint32_t, std::less<uint32_t>>::sort(array, length, effectiveThreads(0, length), std::less<uint32_t>(),
+                                                                                                 &MyCollection<uint32_t>::blockQuickSortLoop<std::less<uint32_t>>); });
+                if (parallel < timeBlockQuickSort(data, size))
+                    return size;
+            }
+            return std::numeric_limits<int>::max();
+        }
+
+        /**
+         * plus petite taille à partir de laquelle radixSortParallel sur tous les coeurs bat les tris radix d'un seul thread que sort() prendrait sinon:
+         * radixSort (LSD) sur des clés étalées et countingSort (min/max puis histogramme) sur des clés dans [0, taille). Jamais sur une machine à un coeur.
+         * Les mesures commencent à la premiere taille où radixSortParallelMSD a au moins deux threads.
+         */
+        static int radixParallelMinSize()
+        {
+            if (SortConfig::hostThreads() <= 1)
+                return std::numeric_limits<int>::max();
+            for (int size = 2 * PARALLEL_MIN_CHUNK; size <= SORT_CALIBRATION_MAX_PARALLEL; size *= 2)
+            {
+                std::vector<uint32_t> wide = randomKeys<uint32_t>(size), narrow(wide);
+                for (uint32_t &key : narrow)
+                    key %= size;
+                std::vector<uint32_t> buffer(size);
+                auto parallel = [&buffer](uint32_t *array, int length)
+                { radixSortParallelMSD(array, &buffer[0], length, false, effectiveThreads(0, length)); };
+                double lsd = timeChunks(wide, size, [&buffer](uint32_t *array, int length)
+                                        { radixSortLSD(array, &buffer[0], length, false); });
+                double counting = timeChunks(narrow, size, [](uint32_t *array, int length)
+                                             {
+                                                 uint32_t min, max;
+                                                 scanMinMax(array, length, min, max);
+                                                 countingSortRange(array, length, min, (std::size_t)(max - min) + 1, false); });
+                if (timeChunks(wide, size, parallel) < lsd && timeChunks(narrow, size, parallel) < counting)
+                    return size;
+            }
+            return std::numeric_limits<int>::max();
+        }
+    };
+
+    /**
+     * Initialisation thread safe (static local en C++11): la calibration ne tourne qu'une fois par programme,
+     * et une seule fois par machine tant que le fichier reste là.
+     */
+    inline SortConfig const &sortConfig()
+    {
+        static SortConfig const config = []()
+        {
+            SortConfig config;
+            std::string path = sortConfigPath();
+            if (config.load(path))
+                return config;
+
+            std::cout << "Calibrating MyCollection::sort() for this machine..." << std::endl;
+            config = SortCalibration::run();
+            if (!config.save(path))
+                std::cerr << "MyCollection: cannot write the sort() thresholds to " << path << ", they will be measured again next time." << std::endl;
+            return config;
+        }();
+        return config;
+    }
+}
@@ -0,0 +1,123 @@
+#pragma once
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <cstdlib>
+#include <thread>
+
+namespace mycollections
+{
+    // fichier des seuils de sort(), dans le répertoire courant sauf si la variable d'environnement MYCOLLECTION_SORT_CONFIG donne un autre chemin.
+    // Un fichier par type de build: un binaire Debug et un binaire optimisé dans le même répertoire ne s'écrasent pas leurs seuils.
+    const char *const SORT_CONFIG_FILE = "mycollection_sort.cfg";
+    const char *const SORT_CONFIG_DEBUG_FILE = "mycollection_sort.debug.cfg";
+
+    /**
+     * Les seuils utilisés par sort(ascending) pour choisir un tri. Les valeurs par défaut ne servent que si la calibration
+     * n'a pas encore tourné, ensuite elles viennent du fichier écrit par la calibration (voir SortCalibration.hpp).
+     */
+    struct SortConfig
+    {
+        int smallSize = 32;              // jusqu'à cette taille: insertionSort
+        int adaptiveRunLength = 256;     // timSort si la longueur moyenne des runs dans l'ordre voulu atteint cette valeur
+        int radixMinSize32 = 1 << 10;    // elements de 4 octets ou moins avec une clé radix: radixSort (countingSort pour les entiers) à partir de cette taille
+        int radixMinSize64 = 1 << 12;    // pareil pour les elements plus grands
+        int parallelMinSize = 1 << 20;   // sampleSort à partir de cette taille
+        int radixParallelMinSize = 1 << 20; // radixSortParallel à partir de cette taille (clés radix)
+        unsigned threads = 0;            // coeurs de la machine calibrée
+        bool optimized = false;          // calibré avec un binaire optimisé (les temps en Debug ne se comparent pas à ceux en -O2)
+
+        // true si le fichier a été lu et correspond à cette machine et à ce type de build
+        bool load(std::string const &path);
+        bool save(std::string const &path) const;
+
+        static unsigned hostThreads() { return std::thread::hardware_concurrency(); }
+        static bool hostOptimized()
+        {
+#ifdef __OPTIMIZE__
+            return true;
+#else
+            return false;
+#endif
+        }
+    };
+
+    inline std::string sortConfigPath()
+    {
+        const char *path = std::getenv("MYCOLLECTION_SORT_CONFIG");
+        if (path != nullptr && path[0] != '\0')
+            return path;
+        return SortConfig::hostOptimized() ? SORT_CONFIG_FILE : SORT_CONFIG_DEBUG_FILE;
+    }
+
+    /**
+     * Une ligne "nom valeur" par seuil, les lignes qui commencent par # sont ignorées, un nom inconnu garde la valeur par défaut.
+     * Un fichier sans radixParallelMinSize a été écrit par une version précédente de la calibration: il est refait.
+     */
+    inline bool SortConfig::load(std::string const &path)
+    {
+        std::ifstream file(path);
+        if (!file)
+            return false;
+
+        SortConfig loaded;
+        bool radixParallelMeasured = false;
+        std::string line;
+        while (std::getline(file, line))
+        {
+            std::istringstream fields(line);
+            std::string name;
+            long long value;
+            if (!(fields >> name) || name[0] == '#')
+                continue;
+            if (!(fields >> value))
+                return false;
+
+            if (name == "smallSize")
+                loaded.smallSize = value;
+            else if (name == "adaptiveRunLength")
+                loaded.adaptiveRunLength = value;
+            else if (name == "radixMinSize32")
+                loaded.radixMinSize32 = value;
+            else if (name == "radixMinSize64")
+                loaded.radixMinSize64 = value;
+            else if (name == "parallelMinSize")
+                loaded.parallelMinSize = value;
+            else if (name == "radixParallelMinSize")
+            {
+                loaded.radixParallelMinSize = value;
+                radixParallelMeasured = true;
+            }
+            else if (name == "threads")
+                loaded.threads = value;
+            else if (name == "optimized")
+                loaded.optimized = value != 0;
+        }
+        if (loaded.threads != hostThreads() || loaded.optimized != hostOptimized() || !radixParallelMeasured)
+            return false; // calibré ailleurs ou par une version précédente: à refaire
+        *this = loaded;
+        return true;
+    }
+
+    inline bool SortConfig::save(std::string const &path) const
+    {
+        std::ofstream file(path);
+        if (!file)
+            return false;
+        file << "# MyCollection::sort() thresholds, written by the calibration (delete this file to calibrate again)\n"
+             << "threads " << threads << "\n"
+             << "optimized " << optimized << "\n"
+             << "smallSize " << smallSize << "\n"
+             << "adaptiveRunLength " << adaptiveRunLength << "\n"
+             << "radixMinSize32 " << radixMinSize32 << "\n"
+             << "radixMinSize64 " << radixMinSize64 << "\n"
+             << "parallelMinSize " << parallelMinSize << "\n"
+             << "radixParallelMinSize " << radixParallelMinSize << "\n";
+        return (bool)file;
+    }
+
+    class SortCalibration;
+
+    // les seuils de cette machine: lus dans le fichier au premier appel, ou calibrés puis écrits s'il n'existe pas (défini dans SortCalibration.hpp)
+    inline SortConfig const &sortConfig();
+}
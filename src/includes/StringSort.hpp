@@ -0,0 +1,191 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <utility>
+#include <algorithm>
+#include <type_traits>
+
+namespace mycollections
+{
+    // en dessous de cette taille les suffixes sont comparés directement (insertion sort) au lieu de partitionner sur les caractères
+    const int STRING_SMALL_RANGE_CUTOFF = 16;
+    // nombre de caractères lus d'un coup par multikeyQuickSort, le dernier octet du mot de 64 bits sert à la longueur
+    const std::size_t STRING_WORD_CHARS = 7;
+
+    /**
+     * Les types triés caractère par caractère par multikeyQuickSort: std::string.
+     * Pour un autre type sortable = false et stringSort se rabat sur un tri par comparaison.
+     */
+    template <typename T>
+    struct StringKey
+    {
+        static const bool sortable = false;
+    };
+
+    template <>
+    struct StringKey<std::string>
+    {
+        static const bool sortable = true;
+
+        /**
+         * Les caractères [depth, depth + 7) en big endian (comparés comme des unsigned char, comme std::string::compare)
+         * puis min(caractères restants, 7) dans l'octet de poids faible: une chaîne plus courte complétée par des 0
+         * passe avant celle qui contient vraiment des '\0'.
+         * Deux mots égaux avec une longueur < 7 sont deux chaînes égales.
+         */
+        static uint64_t word(std::string const &value, std::size_t const depth)
+        {
+            std::size_t const remaining = depth < value.size() ? value.size() - depth : 0;
+            std::size_t const count = std::min(remaining, STRING_WORD_CHARS);
+            const char *const characters = value.data() + depth;
+            uint64_t word = 0;
+            for (std::size_t c = 0; c < count; c++)
+                word |= (uint64_t)(unsigned char)characters[c] << (8 * (STRING_WORD_CHARS - c));
+            return word | count;
+        }
+
+        // comparaison des suffixes à partir de depth, le préfixe commun [0, depth) est déja connu égal
+        static int compareFrom(std::string const &a, std::string const &b, std::size_t const depth)
+        {
+            std::size_t const aSize = a.size() - depth, bSize = b.size() - depth;
+            int result = std::char_traits<char>::compare(a.data() + depth, b.data() + depth, std::min(aSize, bSize));
+            if (result != 0)
+                return result;
+            return aSize < bSize ? -1 : (aSize > bSize ? 1 : 0);
+        }
+    };
+
+    /**
+     * Insertion sort sur [start, end) dont toutes les chaînes ont le même préfixe [0, depth).
+     * Les chaînes sont déplacées (std::move), jamais copiées.
+     */
+    template <typename T>
+    void stringInsertionSort(T *const array, int const start, int const end, std::size_t const depth, bool const descending)
+    {
+        using Key = StringKey<T>;
+        for (int i = start + 1; i < end; i++)
+        {
+            int j = i;
+            T value = std::move(array[i]);
+            while (j > start)
+            {
+                int order = Key::compareFrom(value, array[j - 1], depth);
+                if (!(descending ? order > 0 : order < 0))
+                    break;
+                array[j] = std::move(array[j - 1]);
+                j--;
+            }
+            array[j] = std::move(value);
+        }
+    }
+
+    /**
+     * Multikey quicksort (Bentley & Sedgewick), un quickSort 3 way sur les caractères à partir de la position depth:
+     * 1- [< pivot] et [> pivot] sont triés de nouveau sur les mêmes caractères
+     * 2- [== pivot] partage maintenant depth + 7 caractères, on passe aux suivants sans jamais recomparer le préfixe commun
+     * 3- Si le pivot contient la fin de chaîne, [== pivot] ne contient que des chaînes égales: il n'y a plus rien à faire
+     * Les caractères sont lus 7 par 7 (StringKey::word) dans un cache, un mot par chaîne, partitionné en même temps que les chaînes:
+     * la partition lit un tableau contigu au lieu d'aller chercher les caractères de chaque chaîne sur le tas,
+     * et le cache n'est rempli qu'une fois quand on avance de 7 caractères. Pour des URL qui commencent toutes par "https://www."
+     * le préfixe est lu en 2 passages au lieu de 12.
+     * Les échanges sont des std::swap de std::string: seuls les pointeurs sont échangés, les caractères ne sont jamais copiés.
+     * Comme pour quickSort3WayLoop on empile les plus grandes parties et on continue avec la plus petite: la pile reste en O(log n).
+     */
+    template <typename T>
+    void multikeyQuickSort(T *const array, int const size, bool const descending)
+    {
+        using Key = StringKey<T>;
+        std::vector<uint64_t> cache(size); // en décroissant les mots sont inversés (~), le tri reste croissant sur le cache
+        int start[128], end[128];
+        std::size_t depth[128];
+        bool cached[128];
+        int sp = 0;
+
+        int start_round = 0, end_round = size; // end_round est exclu
+        std::size_t depth_round = 0;
+        bool cached_round = false; // le cache de [start_round, end_round) contient les mots de depth_round
+        while (true)
+        {
+            if (end_round - start_round <= STRING_SMALL_RANGE_CUTOFF)
+            {
+                stringInsertionSort(array, start_round, end_round, depth_round, descending);
+            }
+            else
+            {
+                if (!cached_round)
+                {
+                    for (int i = start_round; i < end_round; i++)
+                    {
+                        uint64_t word = Key::word(array[i], depth_round);
+                        cache[i] = descending ? ~word : word;
+                    }
+                }
+
+                // médiane de trois mots
+                int middle = start_round + (end_round - start_round) / 2;
+                uint64_t a = cache[start_round], b = cache[middle], c = cache[end_round - 1];
+                uint64_t const pivot = std::max(std::min(a, b), std::min(std::max(a, b), c));
+
+                // drapeau hollandais, comme partitionThreeWay
+                int lessEnd = start_round, greaterStart = end_round, i = start_round;
+                while (i < greaterStart)
+                {
+                    if (cache[i] < pivot)
+                    {
+                        std::swap(cache[lessEnd], cache[i]);
+                        std::swap(array[lessEnd++], array[i++]);
+                    }
+                    else if (cache[i] > pivot)
+                    {
+                        std::swap(cache[i], cache[--greaterStart]);
+                        std::swap(array[i], array[greaterStart]);
+                    }
+                    else
+                        i++;
+                }
+
+                // jusqu'à trois parties, la plus petite est traitée tout de suite et les autres sont empilées
+                int partStart[3] = {start_round, lessEnd, greaterStart};
+                int partEnd[3] = {lessEnd, greaterStart, end_round};
+                std::size_t partDepth[3] = {depth_round, depth_round + STRING_WORD_CHARS, depth_round};
+                bool partCached[3] = {true, false, true};
+                if (((descending ? ~pivot : pivot) & 0xFF) < STRING_WORD_CHARS) // fin de chaîne dans le mot: les chaînes égales sont à leur place
+                    partEnd[1] = partStart[1];
+
+                int smallest = -1;
+                for (int p = 0; p < 3; p++)
+                {
+                    if (partEnd[p] - partStart[p] <= 1)
+                        continue;
+                    if (smallest == -1 || partEnd[p] - partStart[p] < partEnd[smallest] - partStart[smallest])
+                        smallest = p;
+                }
+                for (int p = 0; p < 3; p++)
+                {
+                    if (p == smallest || partEnd[p] - partStart[p] <= 1)
+                        continue;
+                    start[sp] = partStart[p];
+                    end[sp] = partEnd[p];
+                    depth[sp] = partDepth[p];
+                    cached[sp++] = partCached[p];
+                }
+                if (smallest != -1)
+                {
+                    start_round = partStart[smallest];
+                    end_round = partEnd[smallest];
+                    depth_round = partDepth[smallest];
+                    cached_round = partCached[smallest];
+                    continue;
+                }
+            }
+
+            if (sp == 0)
+                break;
+            start_round = start[--sp];
+            end_round = end[sp];
+            depth_round = depth[sp];
+            cached_round = cached[sp];
+        }
+    }
+}
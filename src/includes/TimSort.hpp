@@ -0,0 +1,574 @@
+#pragma once
+#include <vector>
+#include <algorithm>
+#include <utility>
+
+namespace mycollections
+{
+    // en dessous de cette taille un seul run trié par insertion binaire
+    const int TIMSORT_MIN_MERGE = 64;
+    // nombre de victoires consécutives d'un run avant de passer en mode galop
+    const int TIMSORT_MIN_GALLOP = 7;
+    // assez de runs en attente pour 2^64 elements avec les invariants de la pile
+    const int TIMSORT_MAX_PENDING = 85;
+
+    /**
+     * Tri adaptatif à la TimSort (Tim Peters), qui profite des runs déja présents dans la collection.
+     * 1- La collection est découpée en runs naturels: croissants, ou strictement décroissants et alors retournés (le tri reste stable).
+     * 2- Un run plus court que minRun (entre 32 et 64) est complété par un insertion sort binaire.
+     * 3- Les runs sont empilés et mergés quand leurs tailles ne respectent plus len[n-2] > len[n-1] + len[n] et len[n-1] > len[n]:
+     *    les merges restent équilibrés et la pile en O(log n).
+     * 4- Le merge commence par chercher (galop) où le premier element de chaque run va dans l'autre, ce qui est déja à sa place ne bouge pas.
+     *    Si un run gagne TIMSORT_MIN_GALLOP fois de suite on passe en mode galop: recherche exponentielle puis binaire du nombre
+     *    d'elements à copier d'un coup.
+     * Sur une collection presque triée (un log avec une petite fin dans le désordre) il y a peu de runs et le tri est proche de O(n).
+     * Le buffer ne dépasse jamais la taille du plus petit des deux runs mergés.
+     */
+    template <typename T, typename Compare>
+    class TimSorter
+    {
+    public:
+        static void sort(T *const array, int const size, Compare comp);
+
+    private:
+        T *const array;
+        Compare comp;
+        std::vector<T> buffer;
+        int minGallop;
+
+        // runs en attente de merge
+        int runBase[TIMSORT_MAX_PENDING];
+        int runLength[TIMSORT_MAX_PENDING];
+        int stackSize;
+
+        TimSorter(T *const array, Compare comp) : array(array), comp(comp), minGallop(TIMSORT_MIN_GALLOP), stackSize(0) {}
+
+        static int minRunLength(int size);
+        int countRunAndMakeAscending(int const start, int const end);
+        void binaryInsertionSort(int const start, int const end, int sortedEnd);
+
+        void pushRun(int const base, int const length);
+        void mergeCollapse();
+        void mergeForceCollapse();
+        void mergeAt(int const i);
+        void mergeLow(int base1, int length1, int base2, int length2);
+        void mergeHigh(int base1, int length1, int base2, int length2);
+
+        int gallopLeft(T const &key, T const *const run, int const length, int const hint) const;
+        int gallopRight(T const &key, T const *const run, int const length, int const hint) const;
+    };
+
+    template <typename T, typename Compare>
+    void TimSorter<T, Compare>::sort(T *const array, int const size, Compare comp)
+    {
+        if (size < 2)
+            return;
+
+        TimSorter sorter(array, comp);
+        int const minRun = minRunLength(size);
+        int start = 0;
+        while (start < size)
+        {
+            int length = sorter.countRunAndMakeAscending(start, size);
+            if (length < minRun)
+            {
+                int forced = std::min(minRun, size - start);
+                sorter.binaryInsertionSort(start, start + forced, start + length);
+                length = forced;
+            }
+            sorter.pushRun(start, length);
+            sorter.mergeCollapse();
+            start += length;
+        }
+        sorter.mergeForceCollapse();
+    }
+
+    /**
+     * size si size < TIMSORT_MIN_MERGE, sinon un minRun entre 32 et 64 tel que size / minRun soit une puissance de 2 ou juste en dessous:
+     * les merges de la fin sont alors équilibrés.
+     */
+    template <typename T, typename Compare>
+    int TimSorter<T, Compare>::minRunLength(int size)
+    {
+        int lowBits = 0; // 1 si un des bits enlevés est à 1
+        while (size >= TIMSORT_MIN_MERGE)
+        {
+            lowBits |= size & 1;
+            size >>= 1;
+        }
+        return size + lowBits;
+    }
+
+    /**
+     * Longueur du run qui commence à start. Un run strictement décroissant (strictement pour que le retourner garde la stabilité)
+     * est retourné pour devenir croissant.
+     */
+    template <typename T, typename Compare>
+    int TimSorter<T, Compare>::countRunAndMakeAscending(int const start, int const end)
+    {
+        int runEnd = start + 1;
+        if (runEnd == end)
+            return 1;
+
+        if (comp(array[runEnd++], array[start]))
+        {
+            while (runEnd < end && comp(array[runEnd], array[runEnd - 1]))
+                runEnd++;
+            std::reverse(array + start, array + runEnd);
+        }
+        else
+        {
+            while (runEnd < end && !comp(array[runEnd], array[runEnd - 1]))
+                runEnd++;
+        }
+        return runEnd - start;
+    }
+
+    /**
+     * Insertion sort de [start, end) dont [start, sortedEnd) est déja trié. La place de chaque element est trouvée par recherche binaire
+     * (log n comparaisons au lieu de n), aprés les elements égaux pour rester stable.
+     */
+    template <typename T, typename Compare>
+    void TimSorter<T, Compare>::binaryInsertionSort(int const start, int const end, int sortedEnd)
+    {
+        for (; sortedEnd < end; sortedEnd++)
+        {
+            int left = start, right = sortedEnd;
+            while (left < right)
+            {
+                int middle = left + (right - left) / 2;
+                if (comp(array[sortedEnd], array[middle]))
+                    right = middle;
+                else
+                    left = middle + 1;
+            }
+            T value = std::move(array[sortedEnd]);
+            std::move_backward(array + left, array + sortedEnd, array + sortedEnd + 1);
+            array[left] = std::move(value);
+        }
+    }
+
+    template <typename T, typename Compare>
+    void TimSorter<T, Compare>::pushRun(int const base, int const length)
+    {
+        runBase[stackSize] = base;
+        runLength[stackSize++] = length;
+    }
+
+    /**
+     * Merge tant que les invariants ne sont pas respectés (en vérifiant aussi len[n-3], l'invariant corrigé de de Gouw et al.).
+     */
+    template <typename T, typename Compare>
+    void TimSorter<T, Compare>::mergeCollapse()
+    {
+        while (stackSize > 1)
+        {
+            int n = stackSize - 2;
+            if ((n > 0 && runLength[n - 1] <= runLength[n] + runLength[n + 1]) ||
+                (n > 1 && runLength[n - 2] <= runLength[n - 1] + runLength[n]))
+            {
+                if (runLength[n - 1] < runLength[n + 1])
+                    n--;
+            }
+            else if (runLength[n] > runLength[n + 1])
+                break;
+            mergeAt(n);
+        }
+    }
+
+    template <typename T, typename Compare>
+    void TimSorter<T, Compare>::mergeForceCollapse()
+    {
+        while (stackSize > 1)
+        {
+            int n = stackSize - 2;
+            if (n > 0 && runLength[n - 1] < runLength[n + 1])
+                n--;
+            mergeAt(n);
+        }
+    }
+
+    /**
+     * Merge des runs i et i + 1. Le début du premier run qui passe avant tout le second et la fin du second qui passe aprés
+     * tout le premier sont déja à leur place: seul le milieu est mergé, avec le plus petit des deux runs dans le buffer.
+     */
+    template <typename T, typename Compare>
+    void TimSorter<T, Compare>::mergeAt(int const i)
+    {
+        int base1 = runBase[i], length1 = runLength[i];
+        int base2 = runBase[i + 1], length2 = runLength[i + 1];
+
+        runLength[i] = length1 + length2;
+        if (i == stackSize - 3)
+        {
+            runBase[i + 1] = runBase[i + 2];
+            runLength[i + 1] = runLength[i + 2];
+        }
+        stackSize--;
+
+        int skipped = gallopRight(array[base2], array + base1, length1, 0);
+        base1 += skipped;
+        length1 -= skipped;
+        if (length1 == 0)
+            return;
+
+        length2 = gallopLeft(array[base1 + length1 - 1], array + base2, length2, length2 - 1);
+        if (length2 == 0)
+            return;
+
+        if (length1 <= length2)
+            mergeLow(base1, length1, base2, length2);
+        else
+            mergeHigh(base1, length1, base2, length2);
+    }
+
+    /**
+     * Position où insérer key dans run[0, length) avant les elements égaux: run[k - 1] < key <= run[k].
+     * Galop à partir de hint (1, 3, 7, 15... elements) puis recherche binaire entre les deux derniers sauts.
+     */
+    template <typename T, typename Compare>
+    int TimSorter<T, Compare>::gallopLeft(T const &key, T const *const run, int const length, int const hint) const
+    {
+        int lastOffset = 0, offset = 1;
+        if (comp(run[hint], key))
+        {
+            // vers la droite: run[hint + lastOffset] < key <= run[hint + offset]
+            int maxOffset = length - hint;
+            while (offset < maxOffset && comp(run[hint + offset], key))
+            {
+                lastOffset = offset;
+                offset = (offset << 1) + 1;
+                if (offset <= 0) // overflow
+                    offset = maxOffset;
+            }
+            offset = std::min(offset, maxOffset);
+            lastOffset += hint;
+            offset += hint;
+        }
+        else
+        {
+            // vers la gauche: run[hint - offset] < key <= run[hint - lastOffset]
+            int maxOffset = hint + 1;
+            while (offset < maxOffset && !comp(run[hint - offset], key))
+            {
+                lastOffset = offset;
+                offset = (offset << 1) + 1;
+                if (offset <= 0)
+                    offset = maxOffset;
+            }
+            offset = std::min(offset, maxOffset);
+            int previous = lastOffset;
+            lastOffset = hint - offset;
+            offset = hint - previous;
+        }
+
+        // run[lastOffset] < key <= run[offset]
+        lastOffset++;
+        while (lastOffset < offset)
+        {
+            int middle = lastOffset + (offset - lastOffset) / 2;
+            if (comp(run[middle], key))
+                lastOffset = middle + 1;
+            else
+                offset = middle;
+        }
+        return offset;
+    }
+
+    /**
+     * Comme gallopLeft mais aprés les elements égaux: run[k - 1] <= key < run[k].
+     */
+    template <typename T, typename Compare>
+    int TimSorter<T, Compare>::gallopRight(T const &key, T const *const run, int const length, int const hint) const
+    {
+        int lastOffset = 0, offset = 1;
+        if (comp(key, run[hint]))
+        {
+            // vers la gauche: run[hint - offset] <= key < run[hint - lastOffset]
+            int maxOffset = hint + 1;
+            while (offset < maxOffset && comp(key, run[hint - offset]))
+            {
+                lastOffset = offset;
+                offset = (offset << 1) + 1;
+                if (offset <= 0)
+                    offset = maxOffset;
+            }
+            offset = std::min(offset, maxOffset);
+            int previous = lastOffset;
+            lastOffset = hint - offset;
+            offset = hint - previous;
+        }
+        else
+        {
+            // vers la droite: run[hint + lastOffset] <= key < run[hint + offset]
+            int maxOffset = length - hint;
+            while (offset < maxOffset && !comp(key, run[hint + offset]))
+            {
+                lastOffset = offset;
+                offset = (offset << 1) + 1;
+                if (offset <= 0)
+                    offset = maxOffset;
+            }
+            offset = std::min(offset, maxOffset);
+            lastOffset += hint;
+            offset += hint;
+        }
+
+        // run[lastOffset] <= key < run[offset]
+        lastOffset++;
+        while (lastOffset < offset)
+        {
+            int middle = lastOffset + (offset - lastOffset) / 2;
+            if (comp(key, run[middle]))
+                offset = middle;
+            else
+                lastOffset = middle + 1;
+        }
+        return offset;
+    }
+
+    /**
+     * Merge de gauche à droite, le premier run (le plus petit) est dans le buffer.
+     * On sait déja que array[base2] passe avant le premier run et que le dernier element du premier run passe aprés tout le second.
+     */
+    template <typename T, typename Compare>
+    void TimSorter<T, Compare>::mergeLow(int base1, int length1, int base2, int length2)
+    {
+        if ((int)buffer.size() < length1)
+            buffer.resize(length1);
+        std::move(array + base1, array + base1 + length1, buffer.begin());
+        T *const left = &buffer[0];
+
+        int cursor1 = 0, cursor2 = base2, destination = base1;
+        array[destination++] = std::move(array[cursor2++]);
+        if (--length2 == 0)
+        {
+            std::move(left + cursor1, left + cursor1 + length1, array + destination);
+            return;
+        }
+        if (length1 == 1)
+        {
+            std::move(array + cursor2, array + cursor2 + length2, array + destination);
+            array[destination + length2] = std::move(left[cursor1]);
+            return;
+        }
+
+        int gallop = minGallop;
+        bool finished = false;
+        while (!finished)
+        {
+            int wins1 = 0, wins2 = 0; // victoires consécutives de chaque run
+
+            // un element à la fois tant qu'aucun run ne gagne trop souvent
+            while (true)
+            {
+                if (comp(array[cursor2], left[cursor1]))
+                {
+                    array[destination++] = std::move(array[cursor2++]);
+                    wins2++;
+                    wins1 = 0;
+                    if (--length2 == 0)
+                    {
+                        finished = true;
+                        break;
+                    }
+                }
+                else
+                {
+                    array[destination++] = std::move(left[cursor1++]);
+                    wins1++;
+                    wins2 = 0;
+                    if (--length1 == 1)
+                    {
+                        finished = true;
+                        break;
+                    }
+                }
+                if ((wins1 | wins2) >= gallop)
+                    break;
+            }
+            if (finished)
+                break;
+
+            // galop: des blocs entiers d'un run passent d'un coup
+            do
+            {
+                wins1 = gallopRight(array[cursor2], left + cursor1, length1, 0);
+                if (wins1 != 0)
+                {
+                    std::move(left + cursor1, left + cursor1 + wins1, array + destination);
+                    destination += wins1;
+                    cursor1 += wins1;
+                    length1 -= wins1;
+                    if (length1 <= 1)
+                    {
+                        finished = true;
+                        break;
+                    }
+                }
+                array[destination++] = std::move(array[cursor2++]);
+                if (--length2 == 0)
+                {
+                    finished = true;
+                    break;
+                }
+
+                wins2 = gallopLeft(left[cursor1], array + cursor2, length2, 0);
+                if (wins2 != 0)
+                {
+                    std::move(array + cursor2, array + cursor2 + wins2, array + destination);
+                    destination += wins2;
+                    cursor2 += wins2;
+                    length2 -= wins2;
+                    if (length2 == 0)
+                    {
+                        finished = true;
+                        break;
+                    }
+                }
+                array[destination++] = std::move(left[cursor1++]);
+                if (--length1 == 1)
+                {
+                    finished = true;
+                    break;
+                }
+                gallop--; // le galop paye: on y revient plus vite la prochaine fois
+            } while (wins1 >= TIMSORT_MIN_GALLOP || wins2 >= TIMSORT_MIN_GALLOP);
+            if (finished)
+                break;
+            gallop = std::max(gallop, 0) + 2; // le galop ne paye plus: pénalité
+        }
+        minGallop = std::max(gallop, 1);
+
+        if (length1 == 1)
+        {
+            std::move(array + cursor2, array + cursor2 + length2, array + destination);
+            array[destination + length2] = std::move(left[cursor1]);
+        }
+        else
+            std::move(left + cursor1, left + cursor1 + length1, array + destination);
+    }
+
+    /**
+     * Merge de droite à gauche, le second run (le plus petit) est dans le buffer. Symétrique de mergeLow.
+     */
+    template <typename T, typename Compare>
+    void TimSorter<T, Compare>::mergeHigh(int base1, int length1, int base2, int length2)
+    {
+        if ((int)buffer.size() < length2)
+            buffer.resize(length2);
+        std::move(array + base2, array + base2 + length2, buffer.begin());
+        T *const right = &buffer[0];
+
+        int cursor1 = base1 + length1 - 1, cursor2 = length2 - 1, destination = base2 + length2 - 1;
+        array[destination--] = std::move(array[cursor1--]);
+        if (--length1 == 0)
+        {
+            std::move(right, right + length2, array + destination - (length2 - 1));
+            return;
+        }
+        if (length2 == 1)
+        {
+            destination -= length1;
+            cursor1 -= length1;
+            std::move_backward(array + cursor1 + 1, array + cursor1 + 1 + length1, array + destination + 1 + length1);
+            array[destination] = std::move(right[cursor2]);
+            return;
+        }
+
+        int gallop = minGallop;
+        bool finished = false;
+        while (!finished)
+        {
+            int wins1 = 0, wins2 = 0;
+
+            while (true)
+            {
+                if (comp(right[cursor2], array[cursor1]))
+                {
+                    array[destination--] = std::move(array[cursor1--]);
+                    wins1++;
+                    wins2 = 0;
+                    if (--length1 == 0)
+                    {
+                        finished = true;
+                        break;
+                    }
+                }
+                else
+                {
+                    array[destination--] = std::move(right[cursor2--]);
+                    wins2++;
+                    wins1 = 0;
+                    if (--length2 == 1)
+                    {
+                        finished = true;
+                        break;
+                    }
+                }
+                if ((wins1 | wins2) >= gallop)
+                    break;
+            }
+            if (finished)
+                break;
+
+            do
+            {
+                wins1 = length1 - gallopRight(right[cursor2], array + base1, length1, length1 - 1);
+                if (wins1 != 0)
+                {
+                    destination -= wins1;
+                    cursor1 -= wins1;
+                    length1 -= wins1;
+                    std::move_backward(array + cursor1 + 1, array + cursor1 + 1 + wins1, array + destination + 1 + wins1);
+                    if (length1 == 0)
+                    {
+                        finished = true;
+                        break;
+                    }
+                }
+                array[destination--] = std::move(right[cursor2--]);
+                if (--length2 == 1)
+                {
+                    finished = true;
+                    break;
+                }
+
+                wins2 = length2 - gallopLeft(array[cursor1], right, length2, length2 - 1);
+                if (wins2 != 0)
+                {
+                    destination -= wins2;
+                    cursor2 -= wins2;
+                    length2 -= wins2;
+                    std::move(right + cursor2 + 1, right + cursor2 + 1 + wins2, array + destination + 1);
+                    if (length2 <= 1)
+                    {
+                        finished = true;
+                        break;
+                    }
+                }
+                array[destination--] = std::move(array[cursor1--]);
+                if (--length1 == 0)
+                {
+                    finished = true;
+                    break;
+                }
+                gallop--;
+            } while (wins1 >= TIMSORT_MIN_GALLOP || wins2 >= TIMSORT_MIN_GALLOP);
+            if (finished)
+                break;
+            gallop = std::max(gallop, 0) + 2;
+        }
+        minGallop = std::max(gallop, 1);
+
+        if (length2 == 1)
+        {
+            destination -= length1;
+            cursor1 -= length1;
+            std::move_backward(array + cursor1 + 1, array + cursor1 + 1 + length1, array + destination + 1 + length1);
+            array[destination] = std::move(right[cursor2]);
+        }
+        else
+            std::move(right, right + length2, array + destination - (length2 - 1));
+    }
+}
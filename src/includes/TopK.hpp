@@ -0,0 +1,127 @@
+#pragma once
+#include <vector>
+#include <functional>
+#include "MyCollection.hpp"
+
+namespace mycollections
+{
+    // nombre d'elements demandés à chaque appel du producteur par TopK::pull
+    const int TOP_K_CHUNK = 4096;
+
+    /**
+     * Les k plus grands (ou plus petits) elements d'un flux, en mémoire O(k): le flux n'est jamais stocké.
+     * Le tas de MyCollection (siftDown, heapSortRange) garde les k meilleurs vus jusqu'ici avec le moins bon à la racine:
+     * un candidat n'entre que s'il passe avant la racine, et sur un long flux presque tous sont rejetés par cette seule comparaison.
+     * Les elements arrivent un par un (push), par morceaux (push(first, last)) ou sont demandés à un producteur (pull).
+     */
+    template <typename T>
+    class TopK
+    {
+    public:
+        explicit TopK(int const k, bool const largest = true) : k(k < 0 ? 0 : k), largest(largest) { this->heap.reserve(this->k); }
+
+        void push(T const &value);
+        template <typename Iterator>
+        void push(Iterator first, Iterator last);
+        // producer(buffer, capacity) écrit au plus capacity elements dans buffer et retourne leur nombre, 0 à la fin du flux
+        template <typename Producer>
+        void pull(Producer producer);
+
+        // les k elements gardés triés, le meilleur d'abord (décroissant pour les plus grands, croissant pour les plus petits)
+        std::vector<T> result() const;
+        int size() const { return this->heap.size(); }
+
+    private:
+        int k;
+        bool largest;
+        std::vector<T> heap; // tas dés qu'il contient k elements, la racine est le moins bon des k
+
+        template <typename Compare>
+        void pushWith(T const &value, Compare comp);
+        template <typename Iterator, typename Compare>
+        void pushWith(Iterator first, Iterator last, Compare comp);
+    };
+
+    /**
+     * comp est l'ordre du résultat (std::greater pour les plus grands): le tas de siftDown met à la racine l'element qui passe aprés les autres,
+     * c'est à dire le moins bon. Tant qu'il y a moins de k elements ils sont juste ajoutés, le tas est construit au k-ième.
+     */
+    template <typename T>
+    template <typename Compare>
+    void TopK<T>::pushWith(T const &value, Compare comp)
+    {
+        int const size = this->heap.size();
+        if (size < this->k)
+        {
+            this->heap.push_back(value);
+            if (size + 1 == this->k)
+                for (int i = this->k / 2 - 1; i >= 0; i--)
+                    MyCollection<T>::siftDown(this->heap.data(), this->k, i, comp);
+        }
+        else if (this->k > 0 && comp(value, this->heap[0]))
+        {
+            this->heap[0] = value;
+            MyCollection<T>::siftDown(this->heap.data(), this->k, 0, comp);
+        }
+    }
+
+    // un morceau: le choix du comparateur est fait une fois, la boucle sur les candidats rejetés n'est qu'une comparaison avec la racine
+    template <typename T>
+    template <typename Iterator, typename Compare>
+    void TopK<T>::pushWith(Iterator first, Iterator last, Compare comp)
+    {
+        for (; first != last && (int)this->heap.size() < this->k; ++first)
+            pushWith(*first, comp);
+        if (this->k == 0)
+            return;
+        T *const heap = this->heap.data();
+        for (; first != last; ++first)
+        {
+            if (!comp(*first, heap[0]))
+                continue;
+            heap[0] = *first;
+            MyCollection<T>::siftDown(heap, this->k, 0, comp);
+        }
+    }
+
+    template <typename T>
+    void TopK<T>::push(T const &value)
+    {
+        if (this->largest)
+            pushWith(value, std::greater<T>());
+        else
+            pushWith(value, std::less<T>());
+    }
+
+    template <typename T>
+    template <typename Iterator>
+    void TopK<T>::push(Iterator first, Iterator last)
+    {
+        if (this->largest)
+            pushWith(first, last, std::greater<T>());
+        else
+            pushWith(first, last, std::less<T>());
+    }
+
+    template <typename T>
+    template <typename Producer>
+    void TopK<T>::pull(Producer producer)
+    {
+        std::vector<T> chunk(TOP_K_CHUNK);
+        int count;
+        while ((count = producer(chunk.data(), TOP_K_CHUNK)) > 0)
+            push(chunk.begin(), chunk.begin() + count);
+    }
+
+    // heapSortRange sur une copie: le tri suit comp, le meilleur en premier
+    template <typename T>
+    std::vector<T> TopK<T>::result() const
+    {
+        std::vector<T> sorted(this->heap);
+        if (this->largest)
+            MyCollection<T>::heapSortRange(sorted.data(), 0, sorted.size(), std::greater<T>());
+        else
+            MyCollection<T>::heapSortRange(sorted.data(), 0, sorted.size(), std::less<T>());
+        return sorted;
+    }
+}